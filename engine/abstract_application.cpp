@@ -7,6 +7,8 @@
 
 #include <GLFW/glfw3.h>
 
+#include <iostream>
+
 namespace engine {
 
 AbstractApplication::CreateInfo AbstractApplication::CreateInfo::readFromCmd(int argc, char** argv)
@@ -19,7 +21,11 @@ AbstractApplication::CreateInfo AbstractApplication::CreateInfo::readFromCmd(int
         TCLAP::ValueArg<std::string> gapiArg(
             "g", "gapi", "Graphics API to use", false, "opengl, vulkan", "string");
 
+        TCLAP::ValueArg<int> memoryStatisticsArg("m", "memory-stats",
+            "Print memory statistics every given number of seconds", false, 0, "seconds");
+
         cmd.add(gapiArg);
+        cmd.add(memoryStatisticsArg);
 
         cmd.parse(argc, argv);
         if (gapiArg.isSet())
@@ -39,6 +45,8 @@ AbstractApplication::CreateInfo AbstractApplication::CreateInfo::readFromCmd(int
                     "invalid argument value, possible values are: opengl, vulkan");
             }
         }
+
+        result.memoryStatisticsInterval = memoryStatisticsArg.getValue();
     }
     catch (TCLAP::ArgException& e)
     {
@@ -63,5 +71,43 @@ renderer::IGraphicsContext& AbstractApplication::context()
     return window().graphicsContext();
 }
 
+void AbstractApplication::dumpMemoryStatistics(int64_t dt)
+{
+    if (m_memoryStatisticsInterval <= 0) return;
+
+    m_memoryStatisticsElapsed += dt;
+    if (m_memoryStatisticsElapsed < m_memoryStatisticsInterval) return;
+    m_memoryStatisticsElapsed = 0;
+
+    constexpr double mib = 1024.0 * 1024.0;
+    const auto statistics = context().memoryStatistics();
+
+    std::cout << "memory statistics:" << std::endl;
+    for (size_t i = 0; i < statistics.heaps.size(); ++i)
+    {
+        const auto& heap = statistics.heaps[i];
+        std::cout << "  heap " << i << (heap.deviceLocal ? " (device local)" : "")
+                  << ": allocated " << heap.allocated / mib << " MiB, used " << heap.used / mib
+                  << " MiB in " << heap.allocationCount << " allocations, " << heap.blockCount
+                  << " blocks, fragmentation " << heap.fragmentation << ", size "
+                  << heap.size / mib << " MiB";
+        if (heap.budget)
+        {
+            std::cout << ", budget " << heap.budget / mib << " MiB, usage " << heap.usage / mib
+                      << " MiB";
+            if (heap.usage > heap.budget) std::cout << " (over budget)";
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "  buffers: " << statistics.bufferCount << ", images: " << statistics.imageCount
+              << ", descriptor pools: " << statistics.descriptorPoolCount
+              << ", uniform chunks: " << statistics.uniformChunkCount << std::endl;
+
+    const auto commands = context().commandStatistics();
+    std::cout << "  state commands: issued " << commands.issued << ", skipped redundant "
+              << commands.skipped << std::endl;
+}
+
 
 }    //  namespace engine
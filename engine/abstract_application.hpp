@@ -31,6 +31,8 @@ public:
         int windowWidth = 640;
         int windowHeight = 480;
         GAPI gapi = GAPI::Vulkan;
+        //  seconds between memory statistics dumps, 0 disables them
+        int memoryStatisticsInterval = 0;
 
         static CreateInfo readFromCmd(int argc, char** argv);
     };
@@ -52,8 +54,13 @@ protected:
     virtual void update(int64_t dt) = 0;
     virtual void perform() = 0;
 
+    void dumpMemoryStatistics(int64_t dt);
+
 protected:
     std::unique_ptr<shell::IResources> m_resources;
+
+    int64_t m_memoryStatisticsInterval = 0;
+    int64_t m_memoryStatisticsElapsed = 0;
 };
 
 }    //  namespace engine
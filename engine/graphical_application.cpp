@@ -24,6 +24,11 @@ GraphicalApplication::GraphicalApplication(int& argc, char** argv)
         m_mainWindow.reset(new shell::glfw::OpenGLWindow(createInfo.windowWidth,
             createInfo.windowHeight, createInfo.windowName));
     }
+
+    m_memoryStatisticsInterval =
+        std::chrono::duration_cast<std::chrono::duration<int64_t, TimeResolution>>(
+            std::chrono::seconds(createInfo.memoryStatisticsInterval))
+            .count();
 }
 
 GraphicalApplication::~GraphicalApplication()
@@ -47,12 +52,14 @@ int GraphicalApplication::mainLoop()
     while (!m_mainWindow->shouldClose())
     {
         auto end = std::chrono::steady_clock::now();
-        update(
+        const auto dt =
             std::chrono::duration_cast<std::chrono::duration<int64_t, TimeResolution>>(end - start)
-                .count());
+                .count();
+        update(dt);
         start = end;
         glfwPollEvents();
         perform();
+        dumpMemoryStatistics(dt);
     }
 
     context().waitIdle();
@@ -26,6 +26,11 @@ QtApplication::QtApplication(int& argc, char** argv)
         m_mainWindow.reset(new shell::qt::OpenGLWindow(createInfo.windowWidth,
             createInfo.windowHeight, createInfo.windowName));
     }
+
+    m_memoryStatisticsInterval =
+        std::chrono::duration_cast<std::chrono::duration<int64_t, TimeResolution>>(
+            std::chrono::seconds(createInfo.memoryStatisticsInterval))
+            .count();
 }
 
 QtApplication::~QtApplication() {}
@@ -37,11 +42,14 @@ int QtApplication::run()
         m_mainWindow.get(), &shell::qt::Window::render, this,
         [start, this]() mutable {
             auto end = std::chrono::steady_clock::now();
-            update(std::chrono::duration_cast<std::chrono::duration<int64_t, TimeResolution>>(
-                end - start)
-                       .count());
+            const auto dt =
+                std::chrono::duration_cast<std::chrono::duration<int64_t, TimeResolution>>(
+                    end - start)
+                    .count();
+            update(dt);
             start = end;
             perform();
+            dumpMemoryStatistics(dt);
         },
         Qt::DirectConnection);
 
@@ -4,10 +4,13 @@
 
 #include <camera.hpp>
 #include <imodel.hpp>
+#include <render_queue.hpp>
 #include <renderable.hpp>
 
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 
@@ -93,16 +96,22 @@ struct Map
             center.z - front().front().size() / 2 + indices.z + blockHalf);
     }
 
-    void draw(OperationContext& context)
+    void enqueue(RenderQueue& queue, IPipeline& pipeline)
     {
-        for (size_t x = 0; x < size(); ++x)
+        enqueue(queue, pipeline, 0, size());
+    }
+
+    //  enqueues the slab of blocks between xBegin and xEnd, blocks share a model and a texture
+    //  and are drawn as instances of a single draw
+    void enqueue(RenderQueue& queue, IPipeline& pipeline, size_t xBegin, size_t xEnd)
+    {
+        for (size_t x = xBegin; x < xEnd; ++x)
             for (size_t y = 0; y < (*this)[x].size(); ++y)
                 for (size_t z = 0; z < (*this)[x][y].size(); ++z)
                 {
                     if (auto& block = (*this)[x][y].at(z); block.has_value())
                     {
-                        block->bind(context);
-                        block->draw(context);
+                        queue.pushInstanced(pipeline, *block);
                     }
                 }
     }
@@ -147,6 +156,8 @@ public:
         Renderable::bind(context);
     }
 
+    Camera& camera() { return m_camera; }
+
     void move(Movement m)
     {
         glm::vec3 initialPos = m_currentPosition;
@@ -302,9 +313,10 @@ Cubic::Cubic(int& argc, char** argv)
     m_pipeline = context().createGraphicsPipeline(
         IGraphicsPipeline::CreateInfo{}
             .addInput<Vertex3DColoredTextured>()
+            .addInput<InstanceTransform>(IGraphicsPipeline::CreateInfo::Binding::INSTANCE)
             .addShader(IPipeline::ShaderInfo{
                 .type = IPipeline::ShaderType::VERTEX,
-                .path = "./shaders/shader.vert.spv",
+                .path = "./shaders/instanced.vert.spv",
             })
             .addShader(IPipeline::ShaderInfo{
                 .type = IPipeline::ShaderType::FRAGMENT,
@@ -413,7 +425,10 @@ void Cubic::update(int64_t dt)
 
 void Cubic::perform()
 {
-    auto context = m_renderer->start(window());
+    //  slabs of the map are recorded on worker threads
+    static constexpr size_t slabSize = 4;
+
+    auto context = m_renderer->startParallel(window());
     context.setViewport({
         .x = 0,
         .y = 0,
@@ -430,10 +445,16 @@ void Cubic::perform()
         .height = window().height(),
     });
 
-    m_pipeline->bind(context);
-
-    m_hero->bind(context);
-    m_map->draw(context);
+    std::vector<std::function<void(OperationContext&)>> tasks;
+    for (size_t x = 0; x < m_map->size(); x += slabSize)
+    {
+        tasks.push_back([this, x](OperationContext& taskContext) {
+            RenderQueue queue;
+            m_map->enqueue(queue, *m_pipeline, x, (std::min)(x + slabSize, m_map->size()));
+            queue.flush(taskContext, { &m_hero->camera() });
+        });
+    }
+    context.record(tasks);
 
     context.submit();
 }
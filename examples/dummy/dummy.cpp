@@ -3,8 +3,15 @@
 #include <glm/ext/matrix_transform.hpp>
 
 #include <camera.hpp>
+#include <culling_batch.hpp>
+#include <icompute_pipeline.hpp>
 #include <imodel.hpp>
+#include <itexture.hpp>
 #include <renderable.hpp>
+#include <texture_table.hpp>
+
+#include <cmath>
+#include <vector>
 
 using namespace renderer;
 
@@ -22,11 +29,49 @@ static constexpr std::array<Vertex3DColoredTextured, 8> s_cubeVertices = {
 static constexpr std::array<uint32_t, 36> s_cubeIndices = { 7, 6, 2, 2, 3, 7, 0, 4, 5, 5, 1, 0, 0,
     2, 6, 6, 4, 0, 7, 3, 1, 1, 5, 7, 3, 2, 0, 0, 1, 3, 4, 6, 7, 7, 5, 4 };
 
+static constexpr size_t s_fieldSize = 512;
+static constexpr float s_fieldSpacing = 0.5f;
+
+struct TextureIndex
+{
+    uint32_t index;
+};
+
+//  passes the slot of a texture in the TextureTable to the fragment shader
+class TextureSlot : public SIShaderInterfaceContainer<TextureSlot>
+{
+public:
+    static constexpr ShaderInterfaceLayout<1> s_layout = { ShaderInterfaceBinding{
+        .type = ShaderBlockType::PUSH_CONSTANT,
+        .stage = ShaderStage::FRAGMENT,
+        .size = UniformValue<TextureIndex>::s_layoutSize,
+    } };
+
+public:
+    TextureSlot(IShaderResourceProvider& provider)
+        : m_index(provider.fetchHandle(ShaderBlockType::PUSH_CONSTANT, m_index.s_layoutSize))
+    {
+        m_descriptors[0].handle = m_index.handle();
+        m_descriptors[0].binding = s_layout[0];
+    }
+
+    void setTexture(const ITexture& texture) { m_index.set({ texture.bindlessIndex() }); }
+
+    virtual std::span<const InterfaceDescriptor> uniforms() const override { return m_descriptors; }
+
+    virtual std::span<const InterfaceDescriptor> dynamicUniforms() const override { return {}; }
+
+private:
+    UniformValue<TextureIndex> m_index;
+    std::array<InterfaceDescriptor, s_layout.size()> m_descriptors;
+};
+
 Dummy::Dummy(int& argc, char** argv)
     : QtApplication(argc, argv)
 {
     m_timer.setIntervalMS(50);
     m_renderer = context().createRenderer({ .multisampling = context().maxSampleCount() });
+    m_computer = context().createComputer({});
 
     m_pipeline = context().createGraphicsPipeline(
         IGraphicsPipeline::CreateInfo{}
@@ -39,7 +84,31 @@ Dummy::Dummy(int& argc, char** argv)
                 .type = IPipeline::ShaderType::FRAGMENT,
                 .path = "./shaders/shader.frag.spv",
             })
-            .addShaderInterfaceContainer<Camera>()
+            .addShaderInterfaceContainer<Camera>(1, IPipeline::DescriptorLifetime::PER_FRAME)
+            .addShaderInterfaceContainer<Renderable>());
+
+    m_cullingPipeline = context().createComputePipeline(
+        IComputePipeline::CreateInfo{}
+            .addShader(IPipeline::ShaderInfo{
+                .type = IPipeline::ShaderType::COMPUTE,
+                .path = "./shaders/cull.comp.spv",
+            })
+            .addShaderInterfaceContainer<CullingBatch>(1, IPipeline::DescriptorLifetime::PER_FRAME)
+            .computeDimensions({ .x = 256 }));
+
+    m_instancedPipeline = context().createGraphicsPipeline(
+        IGraphicsPipeline::CreateInfo{}
+            .addInput<Vertex3DColoredTextured>()
+            .addInput<InstanceTransform>(IGraphicsPipeline::CreateInfo::Binding::INSTANCE)
+            .addShader(IPipeline::ShaderInfo{
+                .type = IPipeline::ShaderType::VERTEX,
+                .path = "./shaders/instanced.vert.spv",
+            })
+            .addShader(IPipeline::ShaderInfo{
+                .type = IPipeline::ShaderType::FRAGMENT,
+                .path = "./shaders/shader.frag.spv",
+            })
+            .addShaderInterfaceContainer<Camera>(1, IPipeline::DescriptorLifetime::PER_FRAME)
             .addShaderInterfaceContainer<Renderable>());
 
     m_camera = std::make_unique<Camera>(context());
@@ -48,7 +117,7 @@ Dummy::Dummy(int& argc, char** argv)
     viewProjection.view = glm::lookAt(
         glm::vec3(0.0f, 3.0f, -4.f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
     viewProjection.projection = glm::perspective(
-        glm::radians(45.0f), window().width() / static_cast<float>(window().height()), 0.1f, 8.0f);
+        glm::radians(45.0f), window().width() / static_cast<float>(window().height()), 0.1f, 64.0f);
 
     m_camera->setViewProjection(viewProjection);
 
@@ -60,6 +129,52 @@ Dummy::Dummy(int& argc, char** argv)
     m_renderable->setTexture(m_texture);
     m_renderable->setPosition(
         glm::translate(glm::identity<glm::mat4>(), glm::vec3(0.0f, 0.0f, 0.0f)));
+
+    //  the room picks its texture from the table where the device has one, the renderable still
+    //  binds the texture on its own for the fallback pipeline
+    if (m_texture->bindlessIndex() != ITexture::s_invalidBindlessIndex)
+    {
+        m_bindlessPipeline = context().createGraphicsPipeline(
+            IGraphicsPipeline::CreateInfo{}
+                .addInput<Vertex3DColoredTextured>()
+                .addShader(IPipeline::ShaderInfo{
+                    .type = IPipeline::ShaderType::VERTEX,
+                    .path = "./shaders/shader.vert.spv",
+                })
+                .addShader(IPipeline::ShaderInfo{
+                    .type = IPipeline::ShaderType::FRAGMENT,
+                    .path = "./shaders/bindless.frag.spv",
+                })
+                .addShaderInterfaceContainer<Camera>(1, IPipeline::DescriptorLifetime::PER_FRAME)
+                .addShaderInterfaceContainer<Renderable>()
+                .addShaderInterfaceContainer<TextureTable>()
+                .addShaderInterfaceContainer<TextureSlot>());
+
+        m_textureTable = std::make_shared<TextureTable>();
+        m_textureSlot = std::make_shared<TextureSlot>(context());
+        m_textureSlot->setTexture(*m_texture);
+    }
+
+    m_cubeModel = context().createModel(IModel::CreateInfo{ s_cubeVertices, s_cubeIndices });
+    m_cube = std::make_unique<Renderable>(context());
+    m_cube->setModel(m_cubeModel);
+    m_cube->setTexture(m_texture);
+
+    std::vector<glm::mat4> transforms;
+    transforms.reserve(s_fieldSize * s_fieldSize);
+    for (size_t x = 0; x < s_fieldSize; ++x)
+        for (size_t z = 0; z < s_fieldSize; ++z)
+        {
+            const glm::vec3 position = { (x - s_fieldSize / 2.0f) * s_fieldSpacing, -1.0f,
+                (z - s_fieldSize / 2.0f) * s_fieldSpacing };
+            transforms.push_back(glm::scale(glm::translate(glm::identity<glm::mat4>(), position),
+                glm::vec3(0.2f)));
+        }
+
+    //  the cube spans [-0.5, 0.5] on every axis
+    m_cubes = std::make_unique<CullingBatch>(
+        context(), *m_cubeModel, transforms, glm::vec4(0.0f, 0.0f, 0.0f, std::sqrt(0.75f)));
+    m_cubes->setFrustum(viewProjection.projection * viewProjection.view);
 }
 
 Dummy::~Dummy() {}
@@ -75,6 +190,10 @@ void Dummy::update(int64_t dt)
 
 void Dummy::perform()
 {
+    auto computeContext = m_computer->start(*m_cubes);
+    m_cullingPipeline->bind(computeContext);
+    m_cubes->bind(computeContext);
+
     auto context = m_renderer->start(window());
     context.setViewport({
         .x = 0,
@@ -92,12 +211,29 @@ void Dummy::perform()
         .height = window().height(),
     });
 
-    m_pipeline->bind(context);
+    context.waitForOperation(computeContext);
+    computeContext.submit();
 
-    m_camera->bind(context);
-
-    m_renderable->bind(context);
+    if (m_bindlessPipeline)
+    {
+        m_bindlessPipeline->bind(context);
+        m_camera->bind(context);
+        m_renderable->bind(context);
+        m_textureTable->bind(context);
+        m_textureSlot->bind(context);
+    }
+    else
+    {
+        m_pipeline->bind(context);
+        m_camera->bind(context);
+        m_renderable->bind(context);
+    }
     m_renderable->draw(context);
 
+    m_instancedPipeline->bind(context);
+    m_camera->bind(context);
+    m_cube->bind(context);
+    m_cubes->draw(context);
+
     context.submit();
 }
@@ -7,10 +7,15 @@
 namespace renderer {
 class IModel;
 class ITexture;
+class IComputer;
 class Camera;
+class CullingBatch;
 class Renderable;
+class TextureTable;
 }
 
+class TextureSlot;
+
 class Dummy : public engine::QtApplication
 {
 public:
@@ -25,11 +30,23 @@ private:
     UpdateTimer<TimeResolution> m_timer;
 
     std::shared_ptr<renderer::IRenderer> m_renderer;
+    std::shared_ptr<renderer::IComputer> m_computer;
     std::shared_ptr<renderer::IPipeline> m_pipeline;
+    std::shared_ptr<renderer::IPipeline> m_cullingPipeline;
+    std::shared_ptr<renderer::IPipeline> m_instancedPipeline;
+    //  samples the texture of the room from the texture table, empty without bindless textures
+    std::shared_ptr<renderer::IPipeline> m_bindlessPipeline;
 
     std::shared_ptr<renderer::Camera> m_camera;
 
     std::shared_ptr<renderer::IModel> m_model;
     std::shared_ptr<renderer::ITexture> m_texture;
     std::shared_ptr<renderer::Renderable> m_renderable;
+    std::shared_ptr<renderer::TextureTable> m_textureTable;
+    std::shared_ptr<TextureSlot> m_textureSlot;
+
+    //  a field of cubes around the room, culled on the gpu
+    std::shared_ptr<renderer::IModel> m_cubeModel;
+    std::shared_ptr<renderer::Renderable> m_cube;
+    std::unique_ptr<renderer::CullingBatch> m_cubes;
 };
@@ -2,9 +2,12 @@
 
 #include "figure.hpp"
 
+#include <camera.hpp>
 #include <renderable.hpp>
 #include <igraphics_context.hpp>
 
+#include <vector>
+
 using namespace renderer;
 
 static constexpr std::array<Vertex3DColoredTextured, 8> s_cubeVertices = {
@@ -44,6 +47,12 @@ Field::Field(IGraphicsContext& context)
             m_blocks[row][col]->setPosition({ col, row });
         }
     }
+
+    m_blocksRenderable = std::make_shared<Renderable>(context);
+    m_blocksRenderable->setModel(m_cube);
+    m_blocksRenderable->setTexture(m_cubeTexture);
+    m_blocksBundle = context.createCommandBundle();
+    updateBlockInstances();
 }
 
 std::shared_ptr<Block> Field::createBlock() const
@@ -97,6 +106,7 @@ int32_t Field::flushRowsAndSpawnFigure()
             m_blocks[pos.y][pos.x] = block;
         }
         flushed = flushRows(topRow, bottomRow);
+        updateBlockInstances();
     }
     m_figure = FiguresMaker::createRandomFigure(*this);
 
@@ -154,21 +164,42 @@ void Field::tryRotateFigure()
     }
 }
 
-void Field::draw(renderer::OperationContext& context) const
+void Field::enqueueFigure(RenderQueue& queue, IPipeline& pipeline) const
 {
     if (m_figure)
     {
-        m_figure->draw(context);
+        m_figure->enqueue(queue, pipeline);
     }
+}
 
+void Field::drawBlocks(OperationContext& context, IPipeline& pipeline, Camera& camera) const
+{
+    context.replay(*m_blocksBundle, [&](OperationContext& bundleContext) {
+        pipeline.bind(bundleContext);
+        camera.bind(bundleContext);
+        m_blocksRenderable->bind(bundleContext);
+        m_blockInstances->bindInstances(bundleContext);
+        m_blockInstances->drawIndexedInstanced(bundleContext, m_cube->indexCount());
+    });
+}
+
+void Field::updateBlockInstances()
+{
+    std::vector<InstanceTransform> instances;
     for (auto& blockLine : m_blocks)
     {
         for (auto& block : blockLine)
         {
             if (block)
             {
-                block->draw(context);
+                const glm::mat4 transform = block->position().position3D();
+                instances.push_back({ transform[0], transform[1], transform[2], transform[3] });
             }
         }
     }
+
+    //  the borders are never flushed, so there is always something to draw
+    m_blockInstances = m_context.createStorageBuffer(
+        IStorageBuffer::CreateInfo{ std::span<const InstanceTransform>{ instances } });
+    m_blocksBundle->invalidate();
 }
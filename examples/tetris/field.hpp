@@ -7,9 +7,15 @@
 #include <memory>
 
 namespace renderer {
+class Camera;
+class IPipeline;
 class OperationContext;
+class RenderQueue;
+class Renderable;
 
+class ICommandBundle;
 class IModel;
+class IStorageBuffer;
 class ITexture;
 class IGraphicsContext;
 }
@@ -41,10 +47,16 @@ public:
 
     bool isBlocksOverflow() const;
 
-    void draw(renderer::OperationContext& context) const;
+    //  the falling figure, its blocks move every few frames
+    void enqueueFigure(renderer::RenderQueue& queue, renderer::IPipeline& pipeline) const;
+    //  the blocks which landed, replayed from a bundle which is recorded again only when they
+    //  change, the context has to be started with IRenderer::startParallel to keep it
+    void drawBlocks(renderer::OperationContext& context, renderer::IPipeline& pipeline,
+        renderer::Camera& camera) const;
 
 private:
     int flushRows(int32_t topRowBound, int32_t bottomRowBound);
+    void updateBlockInstances();
 
 private:
     renderer::IGraphicsContext& m_context;
@@ -53,5 +65,12 @@ private:
     std::shared_ptr<renderer::IModel> m_cube;
     std::shared_ptr<renderer::ITexture> m_cubeTexture;
 
+    //  binds the model and the texture the landed blocks share
+    std::shared_ptr<renderer::Renderable> m_blocksRenderable;
+    //  InstanceTransforms of the landed blocks, kept in a buffer of their own so the bundle
+    //  drawing them doesn't read the per frame instance data of IModel::drawInstanced
+    std::shared_ptr<renderer::IStorageBuffer> m_blockInstances;
+    std::shared_ptr<renderer::ICommandBundle> m_blocksBundle;
+
     std::shared_ptr<Figure> m_figure;
 };
@@ -8,10 +8,9 @@ Block::Block(Renderable renderable)
     : m_renderable(std::move(renderable))
 {}
 
-void Block::draw(OperationContext& context)
+void Block::enqueue(RenderQueue& queue, IPipeline& pipeline)
 {
-    m_renderable.bind(context);
-    m_renderable.draw(context);
+    queue.pushInstanced(pipeline, m_renderable);
 }
 
 void Block::move(int32_t dx, int32_t dy)
@@ -98,11 +97,11 @@ bool Figure::tryRotate()
     return true;
 }
 
-void Figure::draw(OperationContext& commandBuffer)
+void Figure::enqueue(RenderQueue& queue, IPipeline& pipeline)
 {
     for (auto& block : m_blocks)
     {
-        block->draw(commandBuffer);
+        block->enqueue(queue, pipeline);
     }
 }
 
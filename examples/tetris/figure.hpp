@@ -3,6 +3,7 @@
 #include "field.hpp"
 #include "position.hpp"
 
+#include <render_queue.hpp>
 #include <renderable.hpp>
 
 #include <functional>
@@ -12,7 +13,7 @@ class Block
 public:
     Block(renderer::Renderable renderable);
 
-    void draw(renderer::OperationContext& context);
+    void enqueue(renderer::RenderQueue& queue, renderer::IPipeline& pipeline);
 
     bool canMove(int32_t dx, int32_t dy);
     bool canSetPosition(Position position);
@@ -38,7 +39,7 @@ public:
 public:
     Figure(const Field& field);
 
-    void draw(renderer::OperationContext& context);
+    void enqueue(renderer::RenderQueue& queue, renderer::IPipeline& pipeline);
     const std::array<std::shared_ptr<Block>, s_blocksCount>& blocks() const;
     bool hitTest(Position pos) const;
 
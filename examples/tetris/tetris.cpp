@@ -5,6 +5,7 @@
 #include <camera.hpp>
 #include <renderable.hpp>
 
+#include <functional>
 #include <iostream>
 
 #include <GLFW/glfw3.h>
@@ -45,9 +46,10 @@ Tetris::Tetris(int& argc, char** argv)
     m_pipeline = context().createGraphicsPipeline(
         IGraphicsPipeline::CreateInfo{}
             .addInput<Vertex3DColoredTextured>()
+            .addInput<InstanceTransform>(IGraphicsPipeline::CreateInfo::Binding::INSTANCE)
             .addShader(IPipeline::ShaderInfo{
                 .type = IPipeline::ShaderType::VERTEX,
-                .path = "./shaders/shader.vert.spv",
+                .path = "./shaders/instanced.vert.spv",
             })
             .addShader(IPipeline::ShaderInfo{
                 .type = IPipeline::ShaderType::FRAGMENT,
@@ -137,7 +139,8 @@ void Tetris::update(int64_t dt)
 
 void Tetris::perform()
 {
-    auto context = m_renderer->start(window());
+    //  started for record and replay, so the bundle of the landed blocks is kept between frames
+    auto context = m_renderer->startParallel(window());
     context.setViewport({
         .x = 0,
         .y = 0,
@@ -154,8 +157,15 @@ void Tetris::perform()
         .height = window().height(),
     });
 
-    m_pipeline->bind(context);
-    m_camera->bind(context);
-    m_field->draw(context);
+    m_field->drawBlocks(context, *m_pipeline, *m_camera);
+
+    m_field->enqueueFigure(m_renderQueue, *m_pipeline);
+    const std::function<void(OperationContext&)> tasks[] = {
+        [this](OperationContext& taskContext) {
+            m_renderQueue.flush(taskContext, { m_camera.get() });
+        },
+    };
+    context.record(tasks);
+
     context.submit();
 }
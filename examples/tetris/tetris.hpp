@@ -4,6 +4,7 @@
 #include <update_timer.hpp>
 
 #include <graphical_application.hpp>
+#include <render_queue.hpp>
 
 #include <memory>
 
@@ -38,4 +39,5 @@ private:
     UpdateTimer<TimeResolution> m_rotationTimer;
 
     std::shared_ptr<Field> m_field;
+    renderer::RenderQueue m_renderQueue;
 };
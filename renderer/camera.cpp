@@ -14,19 +14,19 @@ void Camera::setView(glm::mat4 view)
 {
     ViewProjection old = m_viewProjection.get();
     old.view = std::move(view);
-    m_viewProjection.set(old);
+    m_viewProjection.stage(old);
 }
 
 void Camera::setProjection(glm::mat4 projection)
 {
     ViewProjection old = m_viewProjection.get();
     old.projection = std::move(projection);
-    m_viewProjection.set(old);
+    m_viewProjection.stage(old);
 }
 
 void Camera::setViewProjection(ViewProjection viewProjection)
 {
-    m_viewProjection.set(std::move(viewProjection));
+    m_viewProjection.stage(std::move(viewProjection));
 }
 
 ViewProjection Camera::viewProjection() const
@@ -36,6 +36,12 @@ ViewProjection Camera::viewProjection() const
 
 void Camera::bind(OperationContext& context)
 {
+    {
+        //  view and projection changed between binds are written once
+        const auto lock = context.lockBindings();
+        m_viewProjection.flush();
+    }
+
     IShaderInterfaceContainer::bind(context);
 }
 
@@ -0,0 +1,153 @@
+#include "culling_batch.hpp"
+
+#include <igraphics_context.hpp>
+#include <imodel.hpp>
+#include <istorage_buffer.hpp>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace renderer {
+
+namespace {
+
+struct BoundingSphere
+{
+    glm::vec4 sphere;
+};
+
+struct DrawCount
+{
+    uint32_t count;
+};
+
+}    //  namespace
+
+CullingBatch::CullingBatch(IGraphicsContext& context, const IModel& model,
+    std::span<const glm::mat4> transforms, glm::vec4 bounds)
+    : m_parameters(context.fetchHandle(ShaderBlockType::UNIFORM_DYNAMIC, m_parameters.s_layoutSize))
+    , m_indexCount(model.indexCount())
+    , m_culled(context.indirectFirstInstanceSupported())
+{
+    ASSERT(!transforms.empty(), "a culling batch needs at least one object");
+
+    std::vector<BoundingSphere> spheres;
+    std::vector<InstanceTransform> instances;
+    spheres.reserve(transforms.size());
+    instances.reserve(transforms.size());
+    for (const auto& transform : transforms)
+    {
+        const float scale = (std::max)({ glm::length(glm::vec3(transform[0])),
+            glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+        spheres.push_back({ glm::vec4(glm::vec3(transform * glm::vec4(glm::vec3(bounds), 1.0f)),
+            bounds.w * scale) });
+        instances.push_back({ transform[0], transform[1], transform[2], transform[3] });
+    }
+
+    const std::vector<DrawIndexedIndirectCommand> commands(transforms.size());
+    const std::array<DrawCount, 1> drawCount{};
+
+    m_bounds = context.createStorageBuffer(
+        IStorageBuffer::CreateInfo{ std::span<const BoundingSphere>{ spheres } });
+    m_transforms = context.createStorageBuffer(
+        IStorageBuffer::CreateInfo{ std::span<const InstanceTransform>{ instances } });
+    m_commands = context.createStorageBuffer(
+        IStorageBuffer::CreateInfo{ std::span<const DrawIndexedIndirectCommand>{ commands } });
+    m_drawCount = context.createStorageBuffer(
+        IStorageBuffer::CreateInfo{ std::span<const DrawCount>{ drawCount } });
+
+    m_parameters.set(CullingParameters{
+        .planes = {},
+        .objectCount = static_cast<uint32_t>(transforms.size()),
+        .indexCount = model.indexCount(),
+    });
+
+    m_descriptors[0].handle = m_parameters.handle();
+    m_descriptors[1].handle = m_bounds->handle();
+    m_descriptors[2].handle = m_commands->handle();
+    m_descriptors[3].handle = m_drawCount->handle();
+    for (size_t i = 0; i < s_layout.size(); ++i)
+    {
+        m_descriptors[i].binding = s_layout[i];
+    }
+}
+
+void CullingBatch::setFrustum(const glm::mat4& viewProjection)
+{
+    const auto row = [&](int i) {
+        return glm::vec4(
+            viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    //  the near plane of a [-1, 1] clip depth, it lies behind the one of [0, 1] and culls less
+    CullingParameters parameters = m_parameters.get();
+    parameters.planes = {
+        row(3) + row(0),
+        row(3) - row(0),
+        row(3) + row(1),
+        row(3) - row(1),
+        row(3) + row(2),
+        row(3) - row(2),
+    };
+    for (auto& plane : parameters.planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    m_parameters.set(parameters);
+}
+
+void CullingBatch::draw(OperationContext& context) const
+{
+    m_transforms->bindInstances(context);
+    if (!m_culled)
+    {
+        m_transforms->drawIndexedInstanced(context, m_indexCount);
+        return;
+    }
+
+    m_commands->drawIndexedIndirect(context, *m_drawCount);
+}
+
+void CullingBatch::bind(OperationContext& context)
+{
+    IShaderInterfaceContainer::bind(context);
+}
+
+std::span<const IShaderInterfaceContainer::InterfaceDescriptor> CullingBatch::uniforms() const
+{
+    return m_descriptors;
+}
+
+std::span<const IShaderInterfaceContainer::InterfaceDescriptor> CullingBatch::dynamicUniforms()
+    const
+{
+    return std::span{ m_descriptors.begin(), 1 };
+}
+
+void CullingBatch::accept(ComputerInfoVisitor& visitor) const
+{
+    m_commands->accept(visitor);
+}
+
+bool CullingBatch::prepare(OperationContext& context)
+{
+    context.setOperationTarget(*this);
+    if (!m_commands->prepare(context)) return false;
+
+    //  the pass appends to the commands, unused ones stay zeroed and draw nothing
+    m_commands->clear(context);
+    m_drawCount->clear(context);
+
+    return true;
+}
+
+void CullingBatch::present(OperationContext& context)
+{
+    //  one invocation per object
+    m_commands->present(context);
+}
+
+}    //  namespace renderer
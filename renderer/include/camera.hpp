@@ -18,6 +18,9 @@ struct ViewProjection
     glm::mat4 projection;
 };
 
+static_assert(ShaderLayout<ShaderLayoutStandard::STD140, ViewProjection>::matchesHost,
+    "view projection is written without repacking");
+
 class Camera : public SIShaderInterfaceContainer<Camera>
 {
 public:
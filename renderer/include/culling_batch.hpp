@@ -0,0 +1,94 @@
+#pragma once
+
+#include <icompute_target.hpp>
+#include <ipipeline.hpp>
+
+#include "../uniform_value.hpp"
+
+#include <ishader_interface.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <memory>
+#include <span>
+
+namespace renderer {
+
+class IGraphicsContext;
+class IModel;
+class IStorageBuffer;
+
+struct CullingParameters
+{
+    //  left, right, bottom, top, near and far, normals point inside
+    std::array<glm::vec4, 6> planes;
+    uint32_t objectCount;
+    uint32_t indexCount;
+};
+
+//  Objects sharing a model whose visibility is decided on the gpu. A compute pass tests the
+//  bounding sphere of every object against the frustum and appends an indirect command for each
+//  visible one, the draw takes the number of commands from the count the pass wrote. The cpu only
+//  writes the frustum per frame, whatever the number of objects. Commands pick the transform of
+//  their object through firstInstance, so the batch is drawn with an InstanceTransform input.
+//  Devices whose indirect commands can't pick their first instance draw every object instead
+class CullingBatch
+    : public SIShaderInterfaceContainer<CullingBatch>
+    , public IComputeTarget
+{
+public:
+    static constexpr ShaderInterfaceLayout<4> s_layout = {
+        ShaderInterfaceBinding{
+            .type = ShaderBlockType::UNIFORM_DYNAMIC,
+            .stage = ShaderStage::COMPUTE,
+        },
+        //  bounding spheres
+        ShaderInterfaceBinding{
+            .type = ShaderBlockType::STORAGE,
+            .stage = ShaderStage::COMPUTE,
+        },
+        //  commands
+        ShaderInterfaceBinding{
+            .type = ShaderBlockType::STORAGE,
+            .stage = ShaderStage::COMPUTE,
+        },
+        //  command count
+        ShaderInterfaceBinding{
+            .type = ShaderBlockType::STORAGE,
+            .stage = ShaderStage::COMPUTE,
+        },
+    };
+
+public:
+    //  bounds is the bounding sphere of the model, center in xyz and radius in w
+    CullingBatch(IGraphicsContext& context, const IModel& model,
+        std::span<const glm::mat4> transforms, glm::vec4 bounds);
+
+    //  viewProjection is the projection times the view of the camera the batch is drawn with
+    void setFrustum(const glm::mat4& viewProjection);
+
+    //  draws the visible objects, the model has to be bound
+    void draw(OperationContext& context) const;
+
+    virtual void bind(OperationContext& context) override;
+    virtual std::span<const InterfaceDescriptor> uniforms() const override;
+    virtual std::span<const InterfaceDescriptor> dynamicUniforms() const override;
+
+    virtual void accept(ComputerInfoVisitor& visitor) const override;
+    virtual bool prepare(OperationContext& context) override;
+    virtual void present(OperationContext& context) override;
+
+private:
+    UniformValue<CullingParameters> m_parameters;
+    std::shared_ptr<IStorageBuffer> m_bounds;
+    std::shared_ptr<IStorageBuffer> m_transforms;
+    std::shared_ptr<IStorageBuffer> m_commands;
+    std::shared_ptr<IStorageBuffer> m_drawCount;
+    uint32_t m_indexCount;
+    bool m_culled;
+    std::array<InterfaceDescriptor, s_layout.size()> m_descriptors;
+};
+
+}    //  namespace renderer
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace renderer {
+
+//  Commands recorded once by OperationContext::replay and replayed by the following calls. What
+//  the commands bind isn't tracked, so the bundle has to be invalidated whenever anything it binds
+//  or draws changes, including the values written to its uniforms
+class ICommandBundle
+{
+public:
+    //  the next replay records the commands again
+    virtual void invalidate() = 0;
+    virtual bool valid() const = 0;
+
+    virtual ~ICommandBundle(){};
+};
+
+}    //  namespace renderer
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <icommand_bundle.hpp>
 #include <icomputer.hpp>
 #include <icompute_pipeline.hpp>
 #include <igraphics_pipeline.hpp>
@@ -29,8 +30,14 @@ public:
     virtual std::shared_ptr<IModel> createModel(std::filesystem::path path) = 0;
     virtual std::shared_ptr<ITexture> createTexture(std::filesystem::path path) = 0;
     virtual std::shared_ptr<ITexture> createTexture(ITexture::CreateInfo createInfo) = 0;
+    virtual std::shared_ptr<ICommandBundle> createCommandBundle() = 0;
 
     virtual Multisampling maxSampleCount() const = 0;
+    //  indirect commands can pick their first instance, gpu culling relies on it
+    virtual bool indirectFirstInstanceSupported() const = 0;
+
+    virtual MemoryStatistics memoryStatistics() const = 0;
+    virtual CommandStatistics commandStatistics() const = 0;
 
     virtual void waitIdle() = 0;
 
@@ -18,7 +18,8 @@ public:
         {
             enum Rate
             {
-                VERTEX
+                VERTEX,
+                INSTANCE
             };
 
             uint32_t binding = 0;
@@ -92,17 +93,19 @@ public:
         };
 
     public:
+        //  every input takes the next binding, its attributes continue the locations of the inputs
+        //  added before
         template <typename T>
-        CreateInfo& addInput()
+        CreateInfo& addInput(Binding::Rate inputRate = Binding::VERTEX)
         {
             T val;
             m_bindings.push_back(Binding{
                 .binding = static_cast<uint32_t>(m_bindings.size()),
                 .stride = sizeof(decltype(val)),
-                .inputRate = Binding::VERTEX,
+                .inputRate = inputRate,
             });
 
-            uint32_t j = 0;
+            uint32_t j = static_cast<uint32_t>(m_attributes.size());
             boost::pfr::for_each_field(val, [&](auto& subVal) {
                 m_attributes.push_back(Attribute{
                     .location = j++,
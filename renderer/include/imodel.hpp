@@ -4,6 +4,8 @@
 
 #include <iresource.hpp>
 
+#include <glm/mat4x4.hpp>
+
 #include <filesystem>
 #include <span>
 
@@ -11,6 +13,8 @@ namespace renderer {
 
 class OperationContext;
 
+static_assert(sizeof(InstanceTransform) == sizeof(glm::mat4));
+
 class IModel : public shell::IResource
 {
 public:
@@ -27,8 +31,16 @@ public:
 public:
     virtual ~IModel(){};
 
+    virtual uint32_t indexCount() const = 0;
+
     virtual void bind(OperationContext& context) = 0;
     virtual void draw(OperationContext& context) = 0;
+    //  draws the model once per transform. The transforms are written to a per frame instance
+    //  buffer bound after the vertices, pipelines read them with an InstanceTransform input.
+    //  Bundles recording it hold per frame data, instances which don't move are drawn from a
+    //  storage buffer with IStorageBuffer::bindInstances instead to keep the bundle
+    virtual void drawInstanced(
+        OperationContext& context, std::span<const glm::mat4> transforms) = 0;
 };
 
 }    //  namespace renderer
@@ -53,12 +53,21 @@ public:
         std::filesystem::path path;
     };
 
+    //  PER_FRAME containers get their descriptors allocated anew for every submission instead of
+    //  caching them, suits containers whose bound resources change every frame
+    enum class DescriptorLifetime
+    {
+        PERSISTENT,
+        PER_FRAME
+    };
+
 protected:
     struct InterfaceContainerInfo
     {
         uint32_t id = 0;
         uint32_t batchSize = 1;
         std::span<const ShaderInterfaceBinding> layout;
+        DescriptorLifetime lifetime = DescriptorLifetime::PERSISTENT;
     };
 
     template <typename Derived>
@@ -66,9 +75,10 @@ protected:
     {
     public:
         template <IsShaderInterfaceContainer T>
-        Derived& addShaderInterfaceContainer(uint32_t batchSize = 1)
+        Derived& addShaderInterfaceContainer(uint32_t batchSize = 1,
+            DescriptorLifetime lifetime = DescriptorLifetime::PERSISTENT)
         {
-            m_interfaceContainers.push_back({ T::sId(), batchSize, T::sLayout() });
+            m_interfaceContainers.push_back({ T::sId(), batchSize, T::sLayout(), lifetime });
             return that();
         }
 
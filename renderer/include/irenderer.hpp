@@ -43,6 +43,9 @@ public:
 
 public:
     virtual OperationContext start(IRenderTarget& target) = 0;
+    //  the pass is recorded by OperationContext::record and replay only, so its tasks may run on
+    //  worker threads. Viewport and scissors set on the context apply to every task
+    virtual OperationContext startParallel(IRenderTarget& target) = 0;
     virtual void finish(OperationContext& context) = 0;
 
     virtual ~IRenderer(){};
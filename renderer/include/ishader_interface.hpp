@@ -17,7 +17,13 @@ enum class ShaderBlockType
     UNIFORM_STATIC = 0,
     UNIFORM_DYNAMIC,
     SAMPLER,
-    STORAGE
+    STORAGE,
+    //  small per draw data written straight into the command stream,
+    //  OpenGL backend falls back to a uniform buffer
+    PUSH_CONSTANT,
+    //  every texture of the context indexed by ITexture::bindlessIndex(), the only binding of its
+    //  container, Vulkan with descriptor indexing only
+    TEXTURE_TABLE
 };
 
 enum class ShaderStage
@@ -33,6 +39,8 @@ struct ShaderInterfaceBinding
     uint32_t count = 1;
     ShaderBlockType type = ShaderBlockType::INVALID;
     ShaderStage stage = ShaderStage::INVALID;
+    //  byte size of the block, required for PUSH_CONSTANT only
+    uint32_t size = 0;
 };
 
 class OperationContext;
@@ -4,6 +4,8 @@
 
 #include <icompute_target.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <span>
 
@@ -13,6 +15,28 @@ namespace renderer {
 
 class IShaderInterfaceHandle;
 
+//  result of an asynchronous read of gpu memory, it gets resolved once the gpu work preceding the
+//  read is complete, so polling it never stalls the pipeline
+class IReadback
+{
+public:
+    virtual ~IReadback() {}
+
+    virtual bool isReady() const = 0;
+    //  empty until the readback is ready
+    virtual std::span<const std::byte> data() const = 0;
+};
+
+//  laid out like VkDrawIndexedIndirectCommand and the GL DrawElementsIndirectCommand
+struct DrawIndexedIndirectCommand
+{
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+};
+
 class IStorageBuffer : virtual public IComputeTarget
 {
 public:
@@ -38,6 +62,20 @@ public:
     virtual std::weak_ptr<IShaderInterfaceHandle> handle() const = 0;
     virtual void bind(OperationContext& context) const = 0;
     virtual void draw(OperationContext& context) const = 0;
+
+    //  zeroes the buffer ahead of the dispatch of a compute context
+    virtual void clear(OperationContext& context) = 0;
+    //  binds the elements, which are InstanceTransforms, as the per instance input of the draws
+    virtual void bindInstances(OperationContext& context) const = 0;
+    //  draws the bound model with the elements, which are DrawIndexedIndirectCommands. The first
+    //  uint32_t of drawCount holds the number of commands to draw
+    virtual void drawIndexedIndirect(
+        OperationContext& context, const IStorageBuffer& drawCount) const = 0;
+    //  draws indexCount indices of the bound model once per element bound by bindInstances
+    virtual void drawIndexedInstanced(OperationContext& context, uint32_t indexCount) const = 0;
+
+    //  reads the buffer contents as they are after the next compute dispatch
+    virtual std::shared_ptr<IReadback> read() = 0;
 };
 
 }    //  namespace renderer
@@ -2,7 +2,9 @@
 
 #include <iresource.hpp>
 
+#include <cstdint>
 #include <filesystem>
+#include <limits>
 
 namespace renderer {
 
@@ -29,10 +31,16 @@ public:
         int height;
     };
 
+    static constexpr uint32_t s_invalidBindlessIndex = (std::numeric_limits<uint32_t>::max)();
+
 public:
     virtual ~ITexture() {}
 
     virtual std::shared_ptr<IShaderInterfaceHandle> uniformHandle() = 0;
+
+    //  slot of the texture in the TEXTURE_TABLE block, s_invalidBindlessIndex if the backend or the
+    //  device has no bindless textures
+    virtual uint32_t bindlessIndex() const { return s_invalidBindlessIndex; }
 };
 
 }    //  namespace renderer
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+
+namespace renderer {
+
+class IModel;
+class IPipeline;
+class IShaderInterfaceContainer;
+class OperationContext;
+class Renderable;
+
+//  Collects draws of a frame and records them sorted by a 64 bit key made of, from the most
+//  significant bits, pipeline, texture, model and depth. Draws sharing a pipeline or a model end
+//  up next to each other and bind it once, draws sharing a texture reuse its descriptor set.
+//  Instanced draws sharing a pipeline, texture and model are merged into a single draw
+class RenderQueue
+{
+public:
+    static constexpr uint32_t s_pipelineBits = 8;
+    static constexpr uint32_t s_textureBits = 16;
+    static constexpr uint32_t s_modelBits = 16;
+    static constexpr uint32_t s_depthBits = 24;
+    static_assert(s_pipelineBits + s_textureBits + s_modelBits + s_depthBits == 64);
+
+public:
+    //  depth is the distance to the camera, nearer draws are recorded first
+    void push(IPipeline& pipeline, Renderable& renderable, float depth = 0.0f);
+    //  the pipeline reads the position of the renderable from an InstanceTransform input
+    void pushInstanced(IPipeline& pipeline, Renderable& renderable);
+
+    //  records the draws and empties the queue. Shared containers, like the camera, are bound
+    //  after every pipeline switch
+    void flush(OperationContext& context,
+        std::initializer_list<IShaderInterfaceContainer*> sharedContainers = {});
+
+    void clear();
+
+    size_t size() const { return m_packets.size(); }
+
+private:
+    struct Packet
+    {
+        uint64_t key;
+        IPipeline* pipeline;
+        IModel* model;
+        Renderable* renderable;
+        bool instanced;
+    };
+
+    void push(IPipeline& pipeline, Renderable& renderable, float depth, bool instanced);
+
+    static uint64_t depthBits(float depth);
+    static uint64_t objectId(
+        std::unordered_map<const void*, uint64_t>& ids, const void* object, uint32_t bits);
+
+private:
+    std::vector<Packet> m_packets;
+    std::vector<glm::mat4> m_transforms;
+
+    //  ids are handed out densely on first use and forgotten with the packets, so objects that
+    //  are gone never hold on to one
+    std::unordered_map<const void*, uint64_t> m_pipelineIds;
+    std::unordered_map<const void*, uint64_t> m_textureIds;
+    std::unordered_map<const void*, uint64_t> m_modelIds;
+};
+
+}    //  namespace renderer
@@ -38,6 +38,8 @@ public:
     virtual void draw(OperationContext& context) const override;
 
     virtual void bind(OperationContext& context) override;
+    //  binds the uniforms and the texture only, for callers which bound the model already
+    void bindUniforms(OperationContext& context);
     virtual std::span<const InterfaceDescriptor> uniforms() const override;
     virtual std::span<const InterfaceDescriptor> dynamicUniforms() const override;
 
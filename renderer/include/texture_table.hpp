@@ -0,0 +1,23 @@
+#pragma once
+
+#include <ishader_interface.hpp>
+
+namespace renderer {
+
+//  Binds every texture of the context at once, shaders pick one with ITexture::bindlessIndex()
+//  passed along with the draw, e.g. in a PUSH_CONSTANT block. Requires a Vulkan device with
+//  descriptor indexing, OpenGL pipelines keep binding textures one by one
+class TextureTable : public SIShaderInterfaceContainer<TextureTable>
+{
+public:
+    static constexpr ShaderInterfaceLayout<1> s_layout = { ShaderInterfaceBinding{
+        .type = ShaderBlockType::TEXTURE_TABLE,
+        .stage = ShaderStage::FRAGMENT,
+    } };
+
+public:
+    virtual std::span<const InterfaceDescriptor> uniforms() const override;
+    virtual std::span<const InterfaceDescriptor> dynamicUniforms() const override;
+};
+
+}    //  namespace renderer
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 struct Scissors
 {
@@ -30,3 +31,40 @@ enum class Multisampling
     MSA_32X = 32,
     MSA_64X = 64,
 };
+
+struct MemoryStatistics
+{
+    struct Heap
+    {
+        bool deviceLocal = false;
+        uint64_t size = 0;
+
+        //  reported by the driver for the whole process, zero if it can't tell
+        uint64_t budget = 0;
+        uint64_t usage = 0;
+
+        //  device memory held by the renderer and the part of it bound to resources
+        uint64_t allocated = 0;
+        uint64_t used = 0;
+        uint32_t blockCount = 0;
+        uint32_t allocationCount = 0;
+
+        //  0 if all the free memory is a single range, close to 1 if it is scattered
+        float fragmentation = 0.0f;
+    };
+
+    std::vector<Heap> heaps;
+
+    uint64_t bufferCount = 0;
+    uint64_t imageCount = 0;
+    uint64_t descriptorPoolCount = 0;
+    uint64_t uniformChunkCount = 0;
+};
+
+//  state commands recorded since the start and the ones skipped because they wouldn't have changed
+//  the bound state
+struct CommandStatistics
+{
+    uint64_t issued = 0;
+    uint64_t skipped = 0;
+};
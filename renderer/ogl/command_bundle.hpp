@@ -0,0 +1,17 @@
+#pragma once
+
+#include <icommand_bundle.hpp>
+
+namespace renderer::ogl {
+
+//  Core profiles have no display lists, replays issue the commands again. Nothing is ever kept, so
+//  the bundle is never valid and every replay records, which is what a bundle that was just
+//  invalidated does on the other backends as well
+class CommandBundle : public ICommandBundle
+{
+public:
+    virtual void invalidate() override {}
+    virtual bool valid() const override { return false; }
+};
+
+}    //  namespace renderer::ogl
@@ -16,8 +16,7 @@ ComputePipeline::~ComputePipeline() {}
 void ComputePipeline::bind(renderer::OperationContext& context)
 {
     get(context).computePipeline = this;
-
-    glUseProgram(m_shaderProgram);
+    get(context).useProgram(m_shaderProgram);
 }
 
 IComputePipeline::ComputeDimensions ComputePipeline::computeDimensions() const
@@ -1,5 +1,7 @@
 #include "computer.hpp"
 
+#include "graphics_context.hpp"
+
 #include <icompute_target.hpp>
 
 namespace renderer::ogl {
@@ -24,6 +26,7 @@ renderer::OperationContext Computer::start(IComputeTarget& target)
 
 void Computer::finish(renderer::OperationContext& context)
 {
+    m_context.countCommands(get(context).commandStatistics);
     context.operationTarget().present(context);
 }
 
@@ -1,5 +1,6 @@
 #include "graphics_context.hpp"
 
+#include "command_bundle.hpp"
 #include "computer.hpp"
 #include "compute_pipeline.hpp"
 #include "graphics_pipeline.hpp"
@@ -18,6 +19,8 @@ GLenum memoryUsage(ShaderBlockType sbt)
     {
         case ShaderBlockType::UNIFORM_STATIC: return GL_STATIC_DRAW;
         case ShaderBlockType::UNIFORM_DYNAMIC: return GL_DYNAMIC_DRAW;
+        //  no push constants in OpenGL, rewritten every draw as a plain uniform buffer
+        case ShaderBlockType::PUSH_CONSTANT: return GL_STREAM_DRAW;
         default: ASSERT(false, "not implemented");
     }
 
@@ -100,6 +103,29 @@ Multisampling GraphicsContext::maxSampleCount() const
 
 void GraphicsContext::waitIdle() {}
 
+//  baseInstance of indirect commands is core since OpenGL 4.2
+bool GraphicsContext::indirectFirstInstanceSupported() const
+{
+    return true;
+}
+
+//  OpenGL has no portable way to query the memory, so only the empty report is provided
+MemoryStatistics GraphicsContext::memoryStatistics() const
+{
+    return MemoryStatistics{};
+}
+
+CommandStatistics GraphicsContext::commandStatistics() const
+{
+    return m_commandStatistics;
+}
+
+void GraphicsContext::countCommands(const CommandStatistics& statistics) const
+{
+    m_commandStatistics.issued += statistics.issued;
+    m_commandStatistics.skipped += statistics.skipped;
+}
+
 std::shared_ptr<IModel> GraphicsContext::createModel(std::filesystem::path path)
 {
     return createModel(IModel::CreateInfo{ path });
@@ -120,5 +146,10 @@ std::shared_ptr<ITexture> GraphicsContext::createTexture(ITexture::CreateInfo cr
     return std::make_shared<Texture>(*this, std::move(createInfo));
 }
 
+std::shared_ptr<ICommandBundle> GraphicsContext::createCommandBundle()
+{
+    return std::make_shared<CommandBundle>();
+}
+
 
 }    //  namespace renderer::ogl
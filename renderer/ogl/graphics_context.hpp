@@ -36,6 +36,10 @@ public:
         IStorageBuffer::CreateInfo createInfo) override;
 
     virtual Multisampling maxSampleCount() const override;
+    virtual bool indirectFirstInstanceSupported() const override;
+
+    virtual MemoryStatistics memoryStatistics() const override;
+    virtual CommandStatistics commandStatistics() const override;
 
     virtual void waitIdle() override;
 
@@ -43,6 +47,13 @@ public:
     virtual std::shared_ptr<IModel> createModel(IModel::CreateInfo createInfo) override;
     virtual std::shared_ptr<ITexture> createTexture(std::filesystem::path path) override;
     virtual std::shared_ptr<ITexture> createTexture(ITexture::CreateInfo createInfo) override;
+    virtual std::shared_ptr<ICommandBundle> createCommandBundle() override;
+
+    //  added by renderers and computers when their operations finish
+    void countCommands(const CommandStatistics& statistics) const;
+
+private:
+    mutable CommandStatistics m_commandStatistics;
 };
 
 }    //  namespace renderer::ogl
@@ -90,7 +90,12 @@ int GraphicsPipeline::primitiveTopology() const
 
 void GraphicsPipeline::bind(renderer::OperationContext& context)
 {
-    get(context).graphicsPipeline = this;
+    auto& specContext = get(context);
+    specContext.graphicsPipeline = this;
+
+    //  every pipeline links a program of its own, so the fixed function state below is still set
+    //  if the program is
+    if (!specContext.useProgram(m_shaderProgram)) return;
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
@@ -109,8 +114,6 @@ void GraphicsPipeline::bind(renderer::OperationContext& context)
     glCullFace(m_cullMode);
     glFrontFace(m_frontFace);
     glPolygonMode(GL_FRONT_AND_BACK, m_polygonMode);
-
-    glUseProgram(m_shaderProgram);
 }
 
 }    //  namespace renderer::ogl
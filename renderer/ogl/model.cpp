@@ -33,18 +33,47 @@ Model::Model(GraphicsContext& context, CreateInfo createInfo) noexcept
     //  texture coord attribute
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
+
+    //  the instance buffer starts with an identity so draws which aren't instanced never read past
+    //  its end
+    const glm::mat4 identity(1.0f);
+    glGenBuffers(1, &m_instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(identity), &identity, GL_STREAM_DRAW);
+    bindInstanceBuffer(m_instanceBuffer);
 }
 
 Model::~Model()
 {
+    glDeleteBuffers(1, &m_instanceBuffer);
     glDeleteBuffers(1, &m_indexBuffer);
     glDeleteBuffers(1, &m_vertexBuffer);
     glDeleteVertexArrays(1, &m_vao);
 }
 
+void Model::bindInstanceBuffer(GLuint buffer)
+{
+    //  a mat4 input takes one location per column, they follow the three vertex attributes
+    constexpr GLuint location = 3;
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (GLuint i = 0; i < 4; ++i)
+    {
+        glVertexAttribPointer(location + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+            (void*)(i * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(location + i);
+        glVertexAttribDivisor(location + i, 1);
+    }
+}
+
+uint32_t Model::indexCount() const
+{
+    return m_indexCount;
+}
+
 void Model::bind(renderer::OperationContext& context)
 {
-    glBindVertexArray(m_vao);
+    get(context).bindVertexArray(m_vao);
 }
 
 void Model::draw(renderer::OperationContext& context)
@@ -53,4 +82,19 @@ void Model::draw(renderer::OperationContext& context)
         GL_UNSIGNED_INT, 0);
 }
 
+void Model::drawInstanced(
+    renderer::OperationContext& context, std::span<const glm::mat4> transforms)
+{
+    if (transforms.empty()) return;
+
+    //  reallocating orphans the storage still read by the draws of the previous call. Storage
+    //  buffers may have taken over the instance input of the vertex array since
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, transforms.size_bytes(), transforms.data(), GL_STREAM_DRAW);
+    bindInstanceBuffer(m_instanceBuffer);
+
+    glDrawElementsInstanced(get(context).graphicsPipeline->primitiveTopology(), m_indexCount,
+        GL_UNSIGNED_INT, 0, transforms.size());
+}
+
 }    //  namespace renderer::ogl
@@ -14,8 +14,15 @@ public:
     explicit Model(GraphicsContext& context, IModel::CreateInfo createInfo) noexcept;
     virtual ~Model();
 
+    //  points the InstanceTransform input of the bound vertex array at the buffer
+    static void bindInstanceBuffer(GLuint buffer);
+
+    virtual uint32_t indexCount() const override;
+
     virtual void bind(renderer::OperationContext& context) override;
     virtual void draw(renderer::OperationContext& context) override;
+    virtual void drawInstanced(renderer::OperationContext& context,
+        std::span<const glm::mat4> transforms) override;
 
 private:
     GraphicsContext& m_context;
@@ -24,6 +31,7 @@ private:
 
     GLuint m_vertexBuffer;
     GLuint m_indexBuffer;
+    GLuint m_instanceBuffer;
     GLuint m_vao;
 };
 
@@ -8,6 +8,10 @@
 
 #include <operation_context.hpp>
 
+#include <glad/glad.h>
+
+#include <cstring>
+
 namespace renderer::ogl {
 
 
@@ -24,6 +28,8 @@ OperationContext::OperationContext(OperationContext&& other)
     , computePipeline(std::move(other.computePipeline))
     , renderer(std::move(other.renderer))
     , computer(std::move(other.computer))
+    , bound(std::move(other.bound))
+    , commandStatistics(other.commandStatistics)
 {
     other.renderer = nullptr;
     other.computer = nullptr;
@@ -46,15 +52,100 @@ void OperationContext::waitForOperation(OperationContext& other)
 
 void OperationContext::setScissors(Scissors scissors) const
 {
+    const bool changed =
+        !bound.scissors || std::memcmp(&*bound.scissors, &scissors, sizeof(Scissors)) != 0;
+    if (!filter(changed)) return;
+
+    bound.scissors = scissors;
     glScissor(scissors.x, scissors.y, scissors.width, scissors.height);
 }
 
 void OperationContext::setViewport(Viewport viewport) const
 {
+    const bool changed =
+        !bound.viewport || std::memcmp(&*bound.viewport, &viewport, sizeof(Viewport)) != 0;
+    if (!filter(changed)) return;
+
+    bound.viewport = viewport;
     glViewport(viewport.x, viewport.y, viewport.width, viewport.height);
     glDepthRangef(viewport.minDepth, viewport.maxDepth);
 }
 
+void OperationContext::record(renderer::OperationContext& context,
+    std::span<const std::function<void(renderer::OperationContext&)>> tasks)
+{
+    for (const auto& task : tasks)
+    {
+        task(context);
+    }
+}
+
+void OperationContext::replay(renderer::OperationContext& context, ICommandBundle& bundle,
+    const std::function<void(renderer::OperationContext&)>& record)
+{
+    //  core profiles have no display lists, the commands are issued again
+    record(context);
+}
+
+bool OperationContext::useProgram(uint32_t program)
+{
+    if (!filter(bound.program != program)) return false;
+
+    bound.program = program;
+    glUseProgram(program);
+    return true;
+}
+
+bool OperationContext::bindVertexArray(uint32_t vertexArray)
+{
+    if (!filter(bound.vertexArray != vertexArray)) return false;
+
+    bound.vertexArray = vertexArray;
+    glBindVertexArray(vertexArray);
+    return true;
+}
+
+bool OperationContext::bindBufferRange(
+    uint32_t target, uint32_t index, uint32_t buffer, intptr_t offset, intptr_t size)
+{
+    auto& buffers = target == GL_UNIFORM_BUFFER ? bound.uniformBuffers : bound.storageBuffers;
+    if (buffers.size() <= index) buffers.resize(index + 1);
+
+    auto& range = buffers[index];
+    const bool changed =
+        !range || range->buffer != buffer || range->offset != offset || range->size != size;
+    if (!filter(changed)) return false;
+
+    range = BoundState::BufferRange{ .buffer = buffer, .offset = offset, .size = size };
+    if (size)
+    {
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+    else
+    {
+        glBindBufferBase(target, index, buffer);
+    }
+    return true;
+}
+
+bool OperationContext::bindTextureUnit(uint32_t unit, uint32_t texture)
+{
+    if (bound.textures.size() <= unit) bound.textures.resize(unit + 1);
+
+    auto& boundTexture = bound.textures[unit];
+    if (!filter(boundTexture != texture)) return false;
+
+    boundTexture = texture;
+    glBindTextureUnit(unit, texture);
+    return true;
+}
+
+bool OperationContext::filter(bool changed) const
+{
+    ++(changed ? commandStatistics.issued : commandStatistics.skipped);
+    return changed;
+}
+
 IPipeline* OperationContext::pipeline()
 {
     if (graphicsPipeline) return graphicsPipeline;
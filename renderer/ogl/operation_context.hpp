@@ -3,9 +3,17 @@
 #include <ipipeline.hpp>
 #include <types.hpp>
 
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
 namespace renderer {
 
 struct OperationContext;
+class ICommandBundle;
 struct IOperationTarget;
 
 namespace ogl {
@@ -31,6 +39,20 @@ struct OperationContext
     void waitForOperation(OperationContext& other);
     void setScissors(Scissors scissors) const;
     void setViewport(Viewport viewport) const;
+    void record(renderer::OperationContext& context,
+        std::span<const std::function<void(renderer::OperationContext&)>> tasks);
+    void replay(renderer::OperationContext& context, ICommandBundle& bundle,
+        const std::function<void(renderer::OperationContext&)>& record);
+    std::unique_lock<std::mutex> lockBindings() const { return {}; }
+
+    //  GL names and enums, glad isn't included by headers. Each returns whether the command was
+    //  issued, it is skipped if the context bound the same state already
+    bool useProgram(uint32_t program);
+    bool bindVertexArray(uint32_t vertexArray);
+    //  target is GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER, a size of 0 binds the whole buffer
+    bool bindBufferRange(
+        uint32_t target, uint32_t index, uint32_t buffer, intptr_t offset, intptr_t size);
+    bool bindTextureUnit(uint32_t unit, uint32_t texture);
 
     IPipeline* pipeline();
     IOperationTarget* operationTarget();
@@ -43,6 +65,35 @@ struct OperationContext
 
     ComputePipeline* computePipeline = nullptr;
     GraphicsPipeline* graphicsPipeline = nullptr;
+
+    //  state bound through this context. GL state is global, so the tracking starts empty for
+    //  every context and objects are expected to be created outside of operations, their
+    //  constructors bind behind the context's back
+    struct BoundState
+    {
+        struct BufferRange
+        {
+            uint32_t buffer = 0;
+            intptr_t offset = 0;
+            intptr_t size = 0;
+        };
+
+        std::optional<uint32_t> program;
+        std::optional<uint32_t> vertexArray;
+        //  indexed by binding
+        std::vector<std::optional<BufferRange>> uniformBuffers;
+        std::vector<std::optional<BufferRange>> storageBuffers;
+        std::vector<std::optional<uint32_t>> textures;
+        std::optional<Viewport> viewport;
+        std::optional<Scissors> scissors;
+    };
+
+    mutable BoundState bound;
+    mutable CommandStatistics commandStatistics;
+
+private:
+    //  counts the command and returns whether it has to be issued
+    bool filter(bool changed) const;
 };
 
 }    //  namespace ogl
@@ -2,6 +2,8 @@
 
 #include "shader_interface_handle.hpp"
 
+#include <operation_context.hpp>
+
 namespace renderer::ogl {
 
 GLenum toGLShaderType(IPipeline::ShaderType type)
@@ -54,7 +56,7 @@ void Pipeline::BindContext::bind(OperationContext& context,
     {
         uniforms[i].handle.lock()->accept(s_handleVisitor);
 
-        s_handleVisitor->bind(bindingIndices[i]);
+        s_handleVisitor->bind(get(context), bindingIndices[i]);
     }
 }
 
@@ -91,6 +93,7 @@ void Pipeline::init(const std::vector<InterfaceContainerInfo>& interfaceContaine
 
     glUseProgram(m_shaderProgram);
 
+    //  PUSH_CONSTANT blocks have no GL counterpart and take a uniform buffer binding like any other
     uint32_t bindingIndex = 0;
     for (auto& container : interfaceContainers)
     {
@@ -83,8 +83,15 @@ renderer::OperationContext Renderer::start(renderer::IRenderTarget& target)
     return result;
 }
 
+renderer::OperationContext Renderer::startParallel(renderer::IRenderTarget& target)
+{
+    return start(target);
+}
+
 void Renderer::finish(renderer::OperationContext& context)
 {
+    m_context.countCommands(get(context).commandStatistics);
+
     if (m_multisampling != Multisampling::MSA_1X)
     {
         auto& specContext = get(context);
@@ -15,6 +15,8 @@ public:
 
 public:
     virtual renderer::OperationContext start(IRenderTarget& target) override;
+    //  GL commands are recorded by the context thread only, the tasks run in order
+    virtual renderer::OperationContext startParallel(IRenderTarget& target) override;
     virtual void finish(renderer::OperationContext& context) override;
 
 private:
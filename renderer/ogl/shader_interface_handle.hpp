@@ -1,9 +1,13 @@
 #pragma once
 
+#include "operation_context.hpp"
+
 #include <ishader_interface_handle.hpp>
 
 #include <glad/glad.h>
 
+#include <cstring>
+
 namespace renderer::ogl {
 
 struct ShaderInterfaceHandle : public IShaderInterfaceHandle
@@ -25,7 +29,7 @@ struct ShaderInterfaceHandle : public IShaderInterfaceHandle
         visitor.visit(*this);
     }
 
-    virtual void bind(GLuint binding) = 0;
+    virtual void bind(OperationContext& context, GLuint binding) = 0;
 };
 
 struct UniformBufferInterfaceHandle : public ShaderInterfaceHandle
@@ -53,27 +57,18 @@ struct UniformBufferInterfaceHandle : public ShaderInterfaceHandle
     {
         glBindBuffer(GL_UNIFORM_BUFFER, buffer);
         glBufferSubData(GL_UNIFORM_BUFFER, 0, size, src);
-        invalidated = true;
+        //  kept on the host, reading the buffer back stalls until the GPU is done with it
+        std::memcpy(mapped, src, size);
     }
 
-    virtual const void* read(size_t size) const override
-    {
-        if (invalidated)
-        {
-            glBindBuffer(GL_UNIFORM_BUFFER, buffer);
-            glGetBufferSubData(GL_UNIFORM_BUFFER, 0, size, mapped);
-            invalidated = false;
-        }
-        return mapped;
-    }
+    virtual const void* read(size_t size) const override { return mapped; }
 
-    virtual void bind(GLuint binding) override
+    virtual void bind(OperationContext& context, GLuint binding) override
     {
-        glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, 0, size);
+        context.bindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, 0, size);
     }
 
     void* mapped = nullptr;
-    mutable bool invalidated = false;
     size_t size;
     GLuint buffer;
 };
@@ -92,10 +87,9 @@ struct TextureInterfaceHandle : public ShaderInterfaceHandle
         return nullptr;
     }
 
-    virtual void bind(GLuint binding) override
+    virtual void bind(OperationContext& context, GLuint binding) override
     {
-        glActiveTexture(GL_TEXTURE0 + binding);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        context.bindTextureUnit(binding, texture);
     }
 
     GLuint texture;
@@ -115,9 +109,9 @@ struct StorageBufferInterfaceHandle : public ShaderInterfaceHandle
         return nullptr;
     }
 
-    virtual void bind(GLuint binding) override
+    virtual void bind(OperationContext& context, GLuint binding) override
     {
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, storageBuffer);
+        context.bindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, storageBuffer, 0, 0);
     }
 
     GLuint storageBuffer;
@@ -4,6 +4,7 @@
 
 #include "utils.hpp"
 #include "graphics_pipeline.hpp"
+#include "model.hpp"
 #include "icomputer.hpp"
 #include "shader_interface_handle.hpp"
 
@@ -11,9 +12,59 @@
 
 namespace renderer::ogl {
 
+Readback::Readback()
+    : m_buffer(0)
+    , m_fence(nullptr)
+{}
+
+Readback::~Readback()
+{
+    if (m_fence) glDeleteSync(m_fence);
+    if (m_buffer) glDeleteBuffers(1, &m_buffer);
+}
+
+void Readback::issue(GLuint src, size_t sizeInBytes)
+{
+    m_data.resize(sizeInBytes);
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeInBytes, nullptr, GL_STREAM_READ);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, src);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeInBytes);
+
+    m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool Readback::isReady() const
+{
+    if (!m_buffer) return false;
+    if (!m_fence) return true;
+
+    const GLenum status = glClientWaitSync(m_fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+
+    glDeleteSync(m_fence);
+    m_fence = nullptr;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, m_data.size(), m_data.data());
+
+    return true;
+}
+
+std::span<const std::byte> Readback::data() const
+{
+    if (!isReady()) return {};
+
+    return m_data;
+}
+
 StorageBuffer::StorageBuffer(GraphicsContext& context, CreateInfo createInfo)
     : m_context(context)
     , m_elementCount(createInfo.initialDataSize)
+    , m_sizeInBytes(createInfo.initialDataSize * createInfo.dataTypeMetaInfo.typeSize)
 {
     glGenVertexArrays(1, &m_vao);
     glGenBuffers(1, &m_buffer);
@@ -59,7 +110,17 @@ void StorageBuffer::present(renderer::OperationContext& context)
 {
     auto [x, y, z] = get(context).computePipeline->computeDimensions();
 
-    glDispatchCompute(m_elementCount / x, y, z);
+    //  the last group is partial if the count isn't a multiple of the group size
+    glDispatchCompute((m_elementCount + x - 1) / x, y, z);
+
+    if (m_pendingReadbacks.empty()) return;
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    for (auto& pending : m_pendingReadbacks)
+    {
+        if (auto readback = pending.lock()) readback->issue(m_buffer, m_sizeInBytes);
+    }
+    m_pendingReadbacks.clear();
 }
 
 std::weak_ptr<IShaderInterfaceHandle> StorageBuffer::handle() const
@@ -69,7 +130,7 @@ std::weak_ptr<IShaderInterfaceHandle> StorageBuffer::handle() const
 
 void StorageBuffer::bind(renderer::OperationContext& context) const
 {
-    glBindVertexArray(m_vao);
+    get(context).bindVertexArray(m_vao);
 }
 
 void StorageBuffer::draw(renderer::OperationContext& context) const
@@ -77,9 +138,50 @@ void StorageBuffer::draw(renderer::OperationContext& context) const
     glDrawArrays(get(context).graphicsPipeline->primitiveTopology(), 0, m_elementCount);
 }
 
+void StorageBuffer::clear(renderer::OperationContext& context)
+{
+    glClearNamedBufferData(m_buffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+
+void StorageBuffer::bindInstances(renderer::OperationContext& context) const
+{
+    //  the model's vertex array has to be bound
+    Model::bindInstanceBuffer(m_buffer);
+}
+
+void StorageBuffer::drawIndexedIndirect(
+    renderer::OperationContext& context, const IStorageBuffer& drawCount) const
+{
+    //  the commands, their count and the instances may have been written by a dispatch
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_buffer);
+    glBindBuffer(GL_PARAMETER_BUFFER, static_cast<const StorageBuffer&>(drawCount).m_buffer);
+    glMultiDrawElementsIndirectCount(get(context).graphicsPipeline->primitiveTopology(),
+        GL_UNSIGNED_INT, nullptr, 0, m_elementCount, 0);
+}
+
+void StorageBuffer::drawIndexedInstanced(
+    renderer::OperationContext& context, uint32_t indexCount) const
+{
+    //  the instances may have been written by a dispatch
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+
+    glDrawElementsInstanced(get(context).graphicsPipeline->primitiveTopology(), indexCount,
+        GL_UNSIGNED_INT, 0, m_elementCount);
+}
+
 GLuint StorageBuffer::framebuffer()
 {
     return 0;
 }
 
+std::shared_ptr<IReadback> StorageBuffer::read()
+{
+    auto readback = std::make_shared<Readback>();
+    m_pendingReadbacks.push_back(readback);
+
+    return readback;
+}
+
 }    //  namespace renderer::ogl
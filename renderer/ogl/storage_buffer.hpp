@@ -8,10 +8,30 @@
 
 #include <boost/pfr.hpp>
 
+#include <vector>
+
 namespace renderer::ogl {
 
 class GraphicsContext;
 
+//  the buffer contents are copied aside after the dispatch and fetched once the fence is signaled
+class Readback : public IReadback
+{
+public:
+    Readback();
+    virtual ~Readback();
+
+    void issue(GLuint src, size_t sizeInBytes);
+
+    virtual bool isReady() const override;
+    virtual std::span<const std::byte> data() const override;
+
+private:
+    GLuint m_buffer;
+    mutable GLsync m_fence;
+    mutable std::vector<std::byte> m_data;
+};
+
 class StorageBuffer : public SpecificOperationTarget<renderer::IStorageBuffer>
 {
 public:
@@ -26,9 +46,17 @@ public:
     virtual std::weak_ptr<IShaderInterfaceHandle> handle() const override;
     virtual void bind(renderer::OperationContext& context) const override;
     virtual void draw(renderer::OperationContext& context) const override;
+    virtual void clear(renderer::OperationContext& context) override;
+    virtual void bindInstances(renderer::OperationContext& context) const override;
+    virtual void drawIndexedIndirect(
+        renderer::OperationContext& context, const IStorageBuffer& drawCount) const override;
+    virtual void drawIndexedInstanced(
+        renderer::OperationContext& context, uint32_t indexCount) const override;
 
     virtual GLuint framebuffer() override;
 
+    virtual std::shared_ptr<IReadback> read() override;
+
 private:
     void init(const void* data, size_t sizeInBytes, size_t typeSize);
 
@@ -36,10 +64,14 @@ private:
     GraphicsContext& m_context;
 
     uint64_t m_elementCount;
+    size_t m_sizeInBytes;
 
     GLuint m_vao;
     GLuint m_buffer;
     std::shared_ptr<IShaderInterfaceHandle> m_handle;
+
+    //  issued after the next dispatch
+    std::vector<std::weak_ptr<Readback>> m_pendingReadbacks;
 };
 
 }    //  namespace renderer::ogl
@@ -3,10 +3,16 @@
 #include "vk/operation_context.hpp"
 #include "ogl/operation_context.hpp"
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <span>
 #include <variant>
 
 namespace renderer {
 
+class ICommandBundle;
+
 class OperationContext : public std::variant<vk::OperationContext, ogl::OperationContext>
 {
 public:
@@ -60,10 +66,36 @@ public:
         std::visit([&](auto& context) { context.setViewport(std::move(viewport)); }, *this);
     };
 
+    //  records every task with a context of its own, on worker threads if the backend supports it,
+    //  and executes them in task order. Task contexts start with nothing bound. Tasks may bind the
+    //  same pipelines and containers, but uniform values have to be written before recording.
+    //  Contexts not started with IRenderer::startParallel run the tasks in order on themselves
+    void record(std::span<const std::function<void(OperationContext&)>> tasks)
+    {
+        std::visit([&](auto& context) { context.record(*this, tasks); }, *this);
+    }
+
+    //  executes the commands of the bundle, recording them with record first if the bundle holds
+    //  none for this render pass. Contexts not started with IRenderer::startParallel run record on
+    //  themselves every time, as OpenGL ones do
+    void replay(ICommandBundle& bundle, const std::function<void(OperationContext&)>& record)
+    {
+        std::visit([&](auto& context) { context.replay(*this, bundle, record); }, *this);
+    }
+
+    //  held while state shared between task contexts is bound, empty outside of record
+    std::unique_lock<std::mutex> lockBindings() const
+    {
+        std::unique_lock<std::mutex> result;
+        std::visit([&](auto& context) { result = context.lockBindings(); }, *this);
+        return result;
+    }
+
 private:
     static size_t createId()
     {
-        static size_t s_currentId = 0;
+        //  task contexts are created on worker threads
+        static std::atomic<size_t> s_currentId = 0;
         return s_currentId++;
     }
 
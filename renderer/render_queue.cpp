@@ -0,0 +1,122 @@
+#include "render_queue.hpp"
+
+#include "renderable.hpp"
+
+#include <imodel.hpp>
+#include <ipipeline.hpp>
+#include <itexture.hpp>
+
+#include <assert.hpp>
+
+#include <algorithm>
+#include <bit>
+
+namespace renderer {
+
+void RenderQueue::push(IPipeline& pipeline, Renderable& renderable, float depth)
+{
+    push(pipeline, renderable, depth, false);
+}
+
+void RenderQueue::pushInstanced(IPipeline& pipeline, Renderable& renderable)
+{
+    push(pipeline, renderable, 0.0f, true);
+}
+
+void RenderQueue::push(IPipeline& pipeline, Renderable& renderable, float depth, bool instanced)
+{
+    auto model = renderable.model().lock();
+    if (!model) return;
+
+    const auto texture = renderable.texture().lock();
+
+    const uint64_t key =
+        objectId(m_pipelineIds, &pipeline, s_pipelineBits)
+            << (s_textureBits + s_modelBits + s_depthBits) |
+        objectId(m_textureIds, texture.get(), s_textureBits) << (s_modelBits + s_depthBits) |
+        objectId(m_modelIds, model.get(), s_modelBits) << s_depthBits | depthBits(depth);
+
+    m_packets.push_back(Packet{
+        .key = key,
+        .pipeline = &pipeline,
+        .model = model.get(),
+        .renderable = &renderable,
+        .instanced = instanced,
+    });
+}
+
+void RenderQueue::flush(OperationContext& context,
+    std::initializer_list<IShaderInterfaceContainer*> sharedContainers)
+{
+    std::sort(m_packets.begin(), m_packets.end(),
+        [](const Packet& lhs, const Packet& rhs) { return lhs.key < rhs.key; });
+
+    IPipeline* boundPipeline = nullptr;
+    IModel* boundModel = nullptr;
+    for (size_t i = 0; i < m_packets.size();)
+    {
+        const auto& packet = m_packets[i];
+        if (packet.pipeline != boundPipeline)
+        {
+            packet.pipeline->bind(context);
+            for (auto* container : sharedContainers)
+            {
+                container->bind(context);
+            }
+
+            boundPipeline = packet.pipeline;
+            boundModel = nullptr;
+        }
+
+        if (packet.model != boundModel)
+        {
+            packet.model->bind(context);
+            boundModel = packet.model;
+        }
+
+        packet.renderable->bindUniforms(context);
+        if (!packet.instanced)
+        {
+            packet.model->draw(context);
+            ++i;
+            continue;
+        }
+
+        //  packets of a group differ in depth only, so sorting made them adjacent
+        m_transforms.clear();
+        for (; i < m_packets.size() && m_packets[i].instanced &&
+             m_packets[i].key >> s_depthBits == packet.key >> s_depthBits;
+             ++i)
+        {
+            m_transforms.push_back(m_packets[i].renderable->position());
+        }
+        packet.model->drawInstanced(context, m_transforms);
+    }
+
+    clear();
+}
+
+void RenderQueue::clear()
+{
+    m_packets.clear();
+    m_pipelineIds.clear();
+    m_textureIds.clear();
+    m_modelIds.clear();
+}
+
+uint64_t RenderQueue::depthBits(float depth)
+{
+    //  the bits of non negative floats are ordered like their values
+    return std::bit_cast<uint32_t>((std::max)(depth, 0.0f)) >> (32 - s_depthBits);
+}
+
+uint64_t RenderQueue::objectId(
+    std::unordered_map<const void*, uint64_t>& ids, const void* object, uint32_t bits)
+{
+    auto [iter, inserted] = ids.emplace(object, ids.size());
+    ASSERT(iter->second < (uint64_t(1) << bits), "too many distinct objects in a render queue");
+
+    return iter->second;
+}
+
+}    //  namespace renderer
@@ -53,6 +53,11 @@ void Renderable::bind(OperationContext& context)
 
     m_model.lock()->bind(context);
 
+    bindUniforms(context);
+}
+
+void Renderable::bindUniforms(OperationContext& context)
+{
     IShaderInterfaceContainer::bind(context);
 }
 
@@ -12,6 +12,8 @@ IShaderInterfaceContainer::~IShaderInterfaceContainer() {}
 
 void IShaderInterfaceContainer::bind(OperationContext& context)
 {
+    //  bind contexts, descriptor caches and allocators are shared by parallel recording tasks
+    const auto lock = context.lockBindings();
     IPipeline* pipeline = &context.pipeline();
 
     if (auto iter = m_contexts.find(pipeline); iter == m_contexts.end())
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <glm/mat2x2.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <boost/pfr.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace renderer {
+
+enum class ShaderLayoutStandard
+{
+    STD140,
+    STD430,
+};
+
+template <ShaderLayoutStandard S, typename T>
+struct ShaderLayout;
+
+namespace detail {
+
+constexpr size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template <ShaderLayoutStandard S, typename T,
+    typename Indices = std::make_index_sequence<boost::pfr::tuple_size_v<T>>>
+struct StructFields;
+
+template <ShaderLayoutStandard S, typename T, size_t... Is>
+struct StructFields<S, T, std::index_sequence<Is...>>
+{
+    template <size_t I>
+    using Type = boost::pfr::tuple_element_t<I, T>;
+    template <size_t I>
+    using Layout = ShaderLayout<S, Type<I>>;
+
+    static constexpr size_t count = sizeof...(Is);
+    static constexpr size_t maxAlignment = (std::max)({ Layout<Is>::alignment... });
+    static constexpr bool matchHost = (Layout<Is>::matchesHost && ...);
+
+    //  the last element is the end of the last field
+    using Offsets = std::array<size_t, count + 1>;
+
+    static constexpr Offsets shaderOffsets()
+    {
+        Offsets result{};
+        size_t offset = 0;
+        ((offset = alignUp(offset, Layout<Is>::alignment), result[Is] = offset,
+             offset += Layout<Is>::size),
+            ...);
+        result[count] = offset;
+        return result;
+    }
+
+    //  offsets the compiler gives the fields of a standard layout aggregate
+    static constexpr Offsets hostOffsets()
+    {
+        Offsets result{};
+        size_t offset = 0;
+        ((offset = alignUp(offset, alignof(Type<Is>)), result[Is] = offset,
+             offset += sizeof(Type<Is>)),
+            ...);
+        result[count] = offset;
+        return result;
+    }
+
+    static void pack(const T& value, std::byte* dst, const Offsets& offsets)
+    {
+        (Layout<Is>::pack(boost::pfr::get<Is>(value), dst + offsets[Is]), ...);
+    }
+};
+
+}    //  namespace detail
+
+//  Alignment, size and offsets of a type inside a uniform (std140) or storage (std430) block,
+//  computed at compile time. matchesHost is true if the C++ representation already has the
+//  shader layout, pack() then is a single copy, otherwise it copies field by field into the
+//  shader offsets. Structs are reflected with boost::pfr, like vertex inputs in addInput
+template <ShaderLayoutStandard S, typename T>
+struct ShaderLayout
+{
+    static_assert(std::is_aggregate_v<T> && std::is_trivially_copyable_v<T>,
+        "type has no shader layout");
+    static_assert(boost::pfr::tuple_size_v<T> > 0, "empty structs have no shader layout");
+
+private:
+    using Fields = detail::StructFields<S, T>;
+
+public:
+    //  std140 rounds the alignment of structs up to the one of a vec4
+    static constexpr size_t alignment = S == ShaderLayoutStandard::STD140
+        ? detail::alignUp(Fields::maxAlignment, 16)
+        : Fields::maxAlignment;
+    static constexpr typename Fields::Offsets offsets = Fields::shaderOffsets();
+    static constexpr size_t size = detail::alignUp(offsets[Fields::count], alignment);
+    static constexpr bool matchesHost = std::is_standard_layout_v<T> && Fields::matchHost &&
+        offsets == Fields::hostOffsets() && size == sizeof(T);
+
+    static void pack(const T& value, std::byte* dst)
+    {
+        if constexpr (matchesHost)
+        {
+            std::memcpy(dst, &value, size);
+        }
+        else
+        {
+            Fields::pack(value, dst, offsets);
+        }
+    }
+};
+
+template <ShaderLayoutStandard S, typename T>
+    requires std::is_arithmetic_v<T>
+struct ShaderLayout<S, T>
+{
+    static_assert(sizeof(T) == 4 && !std::is_same_v<T, bool>,
+        "shader scalars are 32 bit floats or integers");
+
+    static constexpr size_t alignment = 4;
+    static constexpr size_t size = 4;
+    static constexpr bool matchesHost = true;
+
+    static void pack(const T& value, std::byte* dst) { std::memcpy(dst, &value, size); }
+};
+
+template <ShaderLayoutStandard S, glm::length_t L, typename T, glm::qualifier Q>
+struct ShaderLayout<S, glm::vec<L, T, Q>>
+{
+    using Component = ShaderLayout<S, T>;
+
+    //  a vec3 is aligned like a vec4 but takes the size of three components only
+    static constexpr size_t alignment = (L == 2 ? 2 : 4) * Component::size;
+    static constexpr size_t size = L * Component::size;
+    static constexpr bool matchesHost = sizeof(glm::vec<L, T, Q>) == size;
+
+    static void pack(const glm::vec<L, T, Q>& value, std::byte* dst)
+    {
+        std::memcpy(dst, &value, size);
+    }
+};
+
+//  matrices are arrays of column vectors
+template <ShaderLayoutStandard S, glm::length_t C, glm::length_t R, typename T, glm::qualifier Q>
+struct ShaderLayout<S, glm::mat<C, R, T, Q>>
+{
+    using Column = ShaderLayout<S, glm::vec<R, T, Q>>;
+
+    static constexpr size_t alignment = S == ShaderLayoutStandard::STD140
+        ? detail::alignUp(Column::alignment, 16)
+        : Column::alignment;
+    static constexpr size_t stride = detail::alignUp(Column::size, alignment);
+    static constexpr size_t size = stride * C;
+    static constexpr bool matchesHost =
+        stride == sizeof(glm::vec<R, T, Q>) && sizeof(glm::mat<C, R, T, Q>) == size;
+
+    static void pack(const glm::mat<C, R, T, Q>& value, std::byte* dst)
+    {
+        if constexpr (matchesHost)
+        {
+            std::memcpy(dst, &value, size);
+        }
+        else
+        {
+            for (glm::length_t i = 0; i < C; ++i)
+            {
+                Column::pack(value[i], dst + i * stride);
+            }
+        }
+    }
+};
+
+template <ShaderLayoutStandard S, typename T, size_t N>
+struct ShaderLayout<S, std::array<T, N>>
+{
+    using Element = ShaderLayout<S, T>;
+
+    //  std140 rounds the stride of every array up to the one of a vec4
+    static constexpr size_t alignment = S == ShaderLayoutStandard::STD140
+        ? detail::alignUp(Element::alignment, 16)
+        : Element::alignment;
+    static constexpr size_t stride = detail::alignUp(Element::size, alignment);
+    static constexpr size_t size = stride * N;
+    static constexpr bool matchesHost = Element::matchesHost && stride == sizeof(T);
+
+    static void pack(const std::array<T, N>& value, std::byte* dst)
+    {
+        if constexpr (matchesHost)
+        {
+            std::memcpy(dst, value.data(), size);
+        }
+        else
+        {
+            for (size_t i = 0; i < N; ++i)
+            {
+                Element::pack(value[i], dst + i * stride);
+            }
+        }
+    }
+};
+
+}    //  namespace renderer
@@ -1,37 +1,57 @@
 #pragma once
 
+#include "shader_layout.hpp"
+
 #include <ishader_interface_handle.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 
+//  writes are packed into the std430 layout of an array of T
 template <typename T, size_t Size>
 class StorageBufferValue
 {
 public:
-    constexpr static uint64_t s_layoutSize = sizeof(T) * Size;
-    constexpr static uint64_t s_elSize = sizeof(T);
+    using Layout = renderer::ShaderLayout<renderer::ShaderLayoutStandard::STD430,
+        std::array<T, Size>>;
+
+    constexpr static uint64_t s_layoutSize = Layout::size;
+    constexpr static uint64_t s_elSize = Layout::stride;
     constexpr static uint64_t s_elCount = Size;
 
 public:
-    StorageBufferValue(std::shared_ptr<IShaderInterfaceHandle> handler)
+    StorageBufferValue(std::shared_ptr<renderer::IShaderInterfaceHandle> handler)
         : m_shaderInterfaceHandle(handler)
     {}
 
-    inline void set(std::span<T, Size> value)
+    inline void set(std::span<const T, Size> value)
     {
-        std::copy(value.begin(), value.end(), m_value);
-        m_shaderInterfaceHandle->write(m_value.data(), s_layoutSize);
+        std::copy(value.begin(), value.end(), m_value.begin());
+
+        if constexpr (Layout::matchesHost)
+        {
+            m_shaderInterfaceHandle->write(m_value.data(), s_layoutSize);
+        }
+        else
+        {
+            std::vector<std::byte> packed(s_layoutSize);
+            Layout::pack(m_value, packed.data());
+            m_shaderInterfaceHandle->write(packed.data(), s_layoutSize);
+        }
     }
 
-    inline std::span<T, Size> get() const { return m_value; }
+    inline std::span<const T, Size> get() const { return m_value; }
 
-    inline const std::weak_ptr<IShaderInterfaceHandle> handle() const
+    inline const std::weak_ptr<renderer::IShaderInterfaceHandle> handle() const
     {
         return m_shaderInterfaceHandle;
     }
 
 private:
     std::array<T, Size> m_value;
-    std::shared_ptr<IShaderInterfaceHandle> m_shaderInterfaceHandle;
+    std::shared_ptr<renderer::IShaderInterfaceHandle> m_shaderInterfaceHandle;
 };
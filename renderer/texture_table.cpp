@@ -0,0 +1,16 @@
+#include "texture_table.hpp"
+
+namespace renderer {
+
+std::span<const IShaderInterfaceContainer::InterfaceDescriptor> TextureTable::uniforms() const
+{
+    return {};
+}
+
+std::span<const IShaderInterfaceContainer::InterfaceDescriptor> TextureTable::dynamicUniforms()
+    const
+{
+    return {};
+}
+
+}    //  namespace renderer
@@ -1,32 +1,79 @@
 #pragma once
 
 #include "../operation_context.hpp"
+#include "shader_layout.hpp"
 
 #include <ishader_interface_handle.hpp>
 
+#include <array>
+#include <cstddef>
 #include <memory>
 
 namespace renderer {
 
+//  Keeps a host copy of the block, reads never touch the memory the GPU reads from. That memory
+//  is usually write combined on the host and has to be read back with a stall in OpenGL. Writes
+//  are packed into the std140 layout of the block
 template <typename LayoutType>
 class UniformValue
 {
 public:
-    constexpr static uint64_t s_layoutSize = sizeof(LayoutType);
+    using Layout = ShaderLayout<ShaderLayoutStandard::STD140, LayoutType>;
+
+    constexpr static uint64_t s_layoutSize = Layout::size;
 
 public:
     UniformValue(std::shared_ptr<IShaderInterfaceHandle> handler)
         : m_uniformHandle(handler)
+        , m_value{}
+        , m_dirty(false)
     {}
 
-    inline void set(LayoutType value) { m_uniformHandle->write<LayoutType>(&value); }
+    inline void set(LayoutType value)
+    {
+        m_value = std::move(value);
+        m_dirty = false;
+        write();
+    }
+
+    //  changes the host copy only, several stages are written at once by the next flush
+    inline void stage(LayoutType value)
+    {
+        m_value = std::move(value);
+        m_dirty = true;
+    }
+
+    inline void flush()
+    {
+        if (!m_dirty) return;
 
-    inline const LayoutType& get() const { return *m_uniformHandle->read<LayoutType>(); }
+        m_dirty = false;
+        write();
+    }
+
+    inline const LayoutType& get() const { return m_value; }
 
     inline const std::weak_ptr<IShaderInterfaceHandle> handle() const { return m_uniformHandle; }
 
+private:
+    inline void write()
+    {
+        if constexpr (Layout::matchesHost)
+        {
+            m_uniformHandle->write(&m_value, s_layoutSize);
+        }
+        else
+        {
+            std::array<std::byte, s_layoutSize> packed{};
+            Layout::pack(m_value, packed.data());
+            m_uniformHandle->write(packed.data(), s_layoutSize);
+        }
+    }
+
 private:
     std::shared_ptr<IShaderInterfaceHandle> m_uniformHandle;
+    LayoutType m_value;
+    bool m_dirty;
 };
 
 }    //  namespace renderer
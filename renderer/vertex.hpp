@@ -41,6 +41,16 @@ struct Vertex3DColoredTextured
     }
 };
 
+//  Model matrix read per instance, addInput<InstanceTransform>(Binding::INSTANCE) declares a mat4
+//  input, which takes one location for each of its columns
+struct InstanceTransform
+{
+    glm::vec4 column0;
+    glm::vec4 column1;
+    glm::vec4 column2;
+    glm::vec4 column3;
+};
+
 namespace std {
 
 template <>
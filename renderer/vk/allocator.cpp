@@ -1 +1,444 @@
- 
+#include "allocator.hpp"
+
+#include "handles/device.hpp"
+#include "handles/memory.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace renderer::vk {
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+Allocator::Block::Block(const handles::Device& device,
+    uint32_t memoryTypeIndex,
+    ResourceType resourceType,
+    VkDeviceSize size)
+    : m_device(device)
+    , m_memoryTypeIndex(memoryTypeIndex)
+    , m_resourceType(resourceType)
+    , m_size(size)
+    , m_used(0)
+    , m_allocationCount(0)
+    , m_mapped(nullptr)
+    , m_flBitmap(0)
+{
+    m_memory = std::make_unique<handles::Memory>(device,
+        handles::MemoryAllocateInfo{}.allocationSize(size).memoryTypeIndex(memoryTypeIndex));
+
+    m_slBitmaps.fill(0);
+    for (auto& freeLists : m_freeLists) freeLists.fill(s_invalidNode);
+
+    insertFree(createNode(Node{
+        .offset = 0,
+        .size = size,
+        .prevPhysical = s_invalidNode,
+        .nextPhysical = s_invalidNode,
+        .prevFree = s_invalidNode,
+        .nextFree = s_invalidNode,
+        .free = true,
+    }));
+}
+
+Allocator::Block::~Block()
+{
+    DASSERT(isEmpty(), "memory block is destroyed while still in use");
+
+    if (m_mapped) vkUnmapMemory(m_device, *m_memory);
+}
+
+std::optional<Allocator::Allocation> Allocator::Block::allocate(
+    VkDeviceSize size, VkDeviceSize alignment)
+{
+    uint32_t nodeIdx = findFreeNode(size);
+    if (nodeIdx != s_invalidNode &&
+        alignUp(m_nodes[nodeIdx].offset, alignment) + size >
+            m_nodes[nodeIdx].offset + m_nodes[nodeIdx].size)
+    {
+        //  the first fit is misaligned, so look for a range big enough for any padding
+        nodeIdx = findFreeNode(size + alignment - 1);
+    }
+
+    if (nodeIdx == s_invalidNode) return std::nullopt;
+
+    removeFree(nodeIdx);
+
+    const VkDeviceSize alignedOffset = alignUp(m_nodes[nodeIdx].offset, alignment);
+    if (const VkDeviceSize padding = alignedOffset - m_nodes[nodeIdx].offset; padding)
+    {
+        const uint32_t paddingIdx = createNode(Node{
+            .offset = m_nodes[nodeIdx].offset,
+            .size = padding,
+            .prevPhysical = m_nodes[nodeIdx].prevPhysical,
+            .nextPhysical = nodeIdx,
+            .prevFree = s_invalidNode,
+            .nextFree = s_invalidNode,
+            .free = true,
+        });
+
+        if (m_nodes[paddingIdx].prevPhysical != s_invalidNode)
+        {
+            m_nodes[m_nodes[paddingIdx].prevPhysical].nextPhysical = paddingIdx;
+        }
+
+        m_nodes[nodeIdx].prevPhysical = paddingIdx;
+        m_nodes[nodeIdx].offset = alignedOffset;
+        m_nodes[nodeIdx].size -= padding;
+        insertFree(paddingIdx);
+    }
+
+    if (m_nodes[nodeIdx].size > size)
+    {
+        const uint32_t restIdx = createNode(Node{
+            .offset = m_nodes[nodeIdx].offset + size,
+            .size = m_nodes[nodeIdx].size - size,
+            .prevPhysical = nodeIdx,
+            .nextPhysical = m_nodes[nodeIdx].nextPhysical,
+            .prevFree = s_invalidNode,
+            .nextFree = s_invalidNode,
+            .free = true,
+        });
+
+        if (m_nodes[restIdx].nextPhysical != s_invalidNode)
+        {
+            m_nodes[m_nodes[restIdx].nextPhysical].prevPhysical = restIdx;
+        }
+
+        m_nodes[nodeIdx].nextPhysical = restIdx;
+        m_nodes[nodeIdx].size = size;
+        insertFree(restIdx);
+    }
+
+    m_nodes[nodeIdx].free = false;
+    m_used += size;
+    ++m_allocationCount;
+
+    return Allocation{
+        .block = this,
+        .node = nodeIdx,
+        .offset = m_nodes[nodeIdx].offset,
+        .size = size,
+    };
+}
+
+void Allocator::Block::free(uint32_t nodeIdx)
+{
+    DASSERT(nodeIdx < m_nodes.size() && !m_nodes[nodeIdx].free, "invalid memory block node");
+
+    m_used -= m_nodes[nodeIdx].size;
+    --m_allocationCount;
+    m_nodes[nodeIdx].free = true;
+
+    if (const uint32_t prevIdx = m_nodes[nodeIdx].prevPhysical;
+        prevIdx != s_invalidNode && m_nodes[prevIdx].free)
+    {
+        removeFree(prevIdx);
+        m_nodes[prevIdx].size += m_nodes[nodeIdx].size;
+        m_nodes[prevIdx].nextPhysical = m_nodes[nodeIdx].nextPhysical;
+        if (m_nodes[prevIdx].nextPhysical != s_invalidNode)
+        {
+            m_nodes[m_nodes[prevIdx].nextPhysical].prevPhysical = prevIdx;
+        }
+
+        releaseNode(nodeIdx);
+        nodeIdx = prevIdx;
+    }
+
+    if (const uint32_t nextIdx = m_nodes[nodeIdx].nextPhysical;
+        nextIdx != s_invalidNode && m_nodes[nextIdx].free)
+    {
+        removeFree(nextIdx);
+        m_nodes[nodeIdx].size += m_nodes[nextIdx].size;
+        m_nodes[nodeIdx].nextPhysical = m_nodes[nextIdx].nextPhysical;
+        if (m_nodes[nodeIdx].nextPhysical != s_invalidNode)
+        {
+            m_nodes[m_nodes[nodeIdx].nextPhysical].prevPhysical = nodeIdx;
+        }
+
+        releaseNode(nextIdx);
+    }
+
+    insertFree(nodeIdx);
+}
+
+void* Allocator::Block::map()
+{
+    if (!m_mapped)
+    {
+        ASSERT(vkMapMemory(m_device, *m_memory, 0, VK_WHOLE_SIZE, 0, &m_mapped) == VK_SUCCESS,
+            "failed to map memory block");
+    }
+
+    return m_mapped;
+}
+
+VkDeviceSize Allocator::Block::largestFree() const
+{
+    if (!m_flBitmap) return 0;
+
+    //  ranges of the highest non empty list are the biggest ones, but not sorted inside of it
+    const uint32_t fl = std::bit_width(m_flBitmap) - 1;
+    const uint32_t sl = std::bit_width(m_slBitmaps[fl]) - 1;
+
+    VkDeviceSize result = 0;
+    for (uint32_t nodeIdx = m_freeLists[fl][sl]; nodeIdx != s_invalidNode;
+         nodeIdx = m_nodes[nodeIdx].nextFree)
+    {
+        result = (std::max)(result, m_nodes[nodeIdx].size);
+    }
+
+    return result;
+}
+
+std::pair<uint32_t, uint32_t> Allocator::Block::mapping(VkDeviceSize size)
+{
+    if (size < s_slCount) return { 0, static_cast<uint32_t>(size) };
+
+    const uint32_t log2 = std::bit_width(size) - 1;
+    return { log2 - s_slLog2 + 1, static_cast<uint32_t>(size >> (log2 - s_slLog2)) - s_slCount };
+}
+
+uint32_t Allocator::Block::findFreeNode(VkDeviceSize size) const
+{
+    //  round the size up to the next list, so any range of the found list fits
+    if (size >= s_slCount)
+    {
+        size += (VkDeviceSize(1) << (std::bit_width(size) - 1 - s_slLog2)) - 1;
+    }
+
+    auto [fl, sl] = mapping(size);
+    if (fl >= s_flCount) return s_invalidNode;
+
+    uint32_t slBitmap = m_slBitmaps[fl] & (~uint32_t(0) << sl);
+    if (!slBitmap)
+    {
+        const uint64_t flBitmap = fl + 1 < 64 ? m_flBitmap & (~uint64_t(0) << (fl + 1)) : 0;
+        if (!flBitmap) return s_invalidNode;
+
+        fl = std::countr_zero(flBitmap);
+        slBitmap = m_slBitmaps[fl];
+    }
+
+    return m_freeLists[fl][std::countr_zero(slBitmap)];
+}
+
+uint32_t Allocator::Block::createNode(Node node)
+{
+    if (m_unusedNodes.empty())
+    {
+        m_nodes.push_back(node);
+        return m_nodes.size() - 1;
+    }
+
+    const uint32_t nodeIdx = m_unusedNodes.back();
+    m_unusedNodes.pop_back();
+    m_nodes[nodeIdx] = node;
+
+    return nodeIdx;
+}
+
+void Allocator::Block::releaseNode(uint32_t nodeIdx)
+{
+    m_unusedNodes.push_back(nodeIdx);
+}
+
+void Allocator::Block::insertFree(uint32_t nodeIdx)
+{
+    const auto [fl, sl] = mapping(m_nodes[nodeIdx].size);
+
+    const uint32_t headIdx = m_freeLists[fl][sl];
+    m_nodes[nodeIdx].prevFree = s_invalidNode;
+    m_nodes[nodeIdx].nextFree = headIdx;
+    if (headIdx != s_invalidNode) m_nodes[headIdx].prevFree = nodeIdx;
+
+    m_freeLists[fl][sl] = nodeIdx;
+    m_slBitmaps[fl] |= uint32_t(1) << sl;
+    m_flBitmap |= uint64_t(1) << fl;
+}
+
+void Allocator::Block::removeFree(uint32_t nodeIdx)
+{
+    const auto [fl, sl] = mapping(m_nodes[nodeIdx].size);
+    const Node& node = m_nodes[nodeIdx];
+
+    if (node.prevFree != s_invalidNode) m_nodes[node.prevFree].nextFree = node.nextFree;
+    if (node.nextFree != s_invalidNode) m_nodes[node.nextFree].prevFree = node.prevFree;
+
+    if (m_freeLists[fl][sl] == nodeIdx)
+    {
+        m_freeLists[fl][sl] = node.nextFree;
+        if (node.nextFree == s_invalidNode)
+        {
+            m_slBitmaps[fl] &= ~(uint32_t(1) << sl);
+            if (!m_slBitmaps[fl]) m_flBitmap &= ~(uint64_t(1) << fl);
+        }
+    }
+}
+
+Allocator::Allocator(const handles::Device& device)
+    : m_device(device)
+{}
+
+Allocator::~Allocator() {}
+
+std::shared_ptr<handles::Memory> Allocator::allocate(
+    VkMemoryRequirements requirements, uint32_t memoryTypeIndex, ResourceType resourceType)
+{
+    VkDeviceSize alignment = requirements.alignment;
+    VkDeviceSize size = requirements.size;
+
+    //  ranges of non coherent memory are flushed by atoms, so they must not share them
+    const auto propertyFlags = m_device.memoryType(memoryTypeIndex).propertyFlags;
+    if ((propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+        !(propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+    {
+        const VkDeviceSize atomSize =
+            m_device.physicalDeviceProperties().limits.nonCoherentAtomSize;
+        alignment = (std::max)(alignment, atomSize);
+        size = alignUp(size, atomSize);
+    }
+
+    auto& blocks = m_blocks[resourceType][memoryTypeIndex];
+    for (auto& block : blocks)
+    {
+        if (block->size() - block->used() < size) continue;
+
+        if (auto allocation = block->allocate(size, alignment); allocation.has_value())
+        {
+            return std::make_shared<handles::Memory>(m_device, allocation.value());
+        }
+    }
+
+    //  big resources get a dedicated block instead of fragmenting the shared ones, lazily
+    //  allocated memory is committed per memory object, so it is never shared either
+    const VkDeviceSize defaultSize = blockSize(memoryTypeIndex);
+    const bool dedicated =
+        size > defaultSize / 2 || (propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+    auto& block = blocks.emplace_back(std::make_unique<Block>(m_device, memoryTypeIndex,
+        resourceType, dedicated ? size : defaultSize));
+
+    auto allocation = block->allocate(size, alignment);
+    ASSERT(allocation.has_value(), "failed to allocate memory from a new block");
+
+    return std::make_shared<handles::Memory>(m_device, allocation.value());
+}
+
+void Allocator::free(Allocation allocation)
+{
+    DASSERT(allocation.isValid());
+
+    Block* block = allocation.block;
+    block->free(allocation.node);
+
+    if (!block->isEmpty()) return;
+
+    //  keep a single empty block per memory type to avoid reallocation on churn
+    auto& blocks = m_blocks[block->resourceType()][block->memoryTypeIndex()];
+    const bool keep = block->size() <= blockSize(block->memoryTypeIndex()) &&
+        !(m_device.memoryType(block->memoryTypeIndex()).propertyFlags &
+            VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) &&
+        std::count_if(blocks.begin(), blocks.end(), [](auto& b) { return b->isEmpty(); }) == 1;
+    if (keep) return;
+
+    std::erase_if(blocks, [block](auto& b) { return b.get() == block; });
+}
+
+std::array<Allocator::HeapStatistics, VK_MAX_MEMORY_HEAPS> Allocator::statistics() const
+{
+    std::array<HeapStatistics, VK_MAX_MEMORY_HEAPS> result{};
+    for (const auto& memoryTypes : m_blocks)
+    {
+        for (const auto& blocks : memoryTypes)
+        {
+            for (const auto& block : blocks)
+            {
+                auto& heap = result[m_device.memoryType(block->memoryTypeIndex()).heapIndex];
+                heap.allocated += block->size();
+                heap.used += block->used();
+                heap.free += block->size() - block->used();
+                heap.largestFree = (std::max)(heap.largestFree, block->largestFree());
+                heap.blockCount += 1;
+                heap.allocationCount += block->allocationCount();
+            }
+        }
+    }
+
+    return result;
+}
+
+uint32_t Allocator::findMemoryType(const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags required,
+    VkMemoryPropertyFlags preferred) const
+{
+    std::optional<uint32_t> fallback;
+    for (uint32_t i = 0; i < m_device.memoryTypeCount(); ++i)
+    {
+        if (!(requirements.memoryTypeBits & (1 << i))) continue;
+
+        const auto propertyFlags = m_device.memoryType(i).propertyFlags;
+        if ((propertyFlags & required) != required) continue;
+
+        if ((propertyFlags & preferred) == preferred && isAffordable(i, requirements.size))
+        {
+            return i;
+        }
+
+        if (!fallback.has_value()) fallback = i;
+    }
+
+    ASSERT(fallback.has_value(), "failed to find suitable memory type!");
+    return fallback.value_or(0);
+}
+
+VkDeviceSize Allocator::blockSize(uint32_t memoryTypeIndex) const
+{
+    const VkDeviceSize heapSize =
+        m_device.memoryHeap(m_device.memoryType(memoryTypeIndex).heapIndex).size;
+
+    return (std::min)(s_defaultBlockSize, heapSize / 8);
+}
+
+bool Allocator::isAffordable(uint32_t memoryTypeIndex, VkDeviceSize size) const
+{
+    constexpr VkMemoryPropertyFlags bar =
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+
+    //  only the host visible window into the video memory is scarce
+    const auto memoryType = m_device.memoryType(memoryTypeIndex);
+    if ((memoryType.propertyFlags & bar) != bar) return true;
+
+    const uint32_t heapIndex = memoryType.heapIndex;
+    const VkDeviceSize heapSize = m_device.memoryHeap(heapIndex).size;
+
+    //  the allocation may need a whole new block
+    const VkDeviceSize growth = (std::max)(size, blockSize(memoryTypeIndex));
+
+    if (const auto budget = m_device.memoryBudget(); budget.has_value())
+    {
+        if (budget->heapUsage[heapIndex] + growth >
+            budget->heapBudget[heapIndex] / 100 * s_budgetSharePercent)
+        {
+            return false;
+        }
+    }
+
+    VkDeviceSize largestDeviceLocalHeap = 0;
+    for (uint32_t i = 0; i < m_device.memoryHeapCount(); ++i)
+    {
+        const auto heap = m_device.memoryHeap(i);
+        if (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        {
+            largestDeviceLocalHeap = (std::max)(largestDeviceLocalHeap, heap.size);
+        }
+    }
+
+    //  resizable bar maps (nearly) all of the video memory, so only the budget limits it
+    if (heapSize >= largestDeviceLocalHeap / 2) return true;
+
+    return statistics()[heapIndex].allocated + growth <= heapSize / s_smallBarShareDivisor;
+}
+
+}    //  namespace renderer::vk
@@ -1 +1,168 @@
- 
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class Device;
+struct Memory;
+}
+
+//  Sub-allocates device memory: every memory type owns a list of large blocks and every block
+//  hands out aligned ranges from a two-level segregated fit (TLSF) free list
+class Allocator
+{
+public:
+    //  linear (buffers) and optimal (images) resources live in separate blocks, so
+    //  bufferImageGranularity never has to be taken into account inside of a block
+    enum ResourceType : uint8_t
+    {
+        LINEAR,
+        OPTIMAL,
+        COUNT
+    };
+
+    class Block;
+
+    struct Allocation
+    {
+        Block* block = nullptr;
+        uint32_t node = 0;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+
+        bool isValid() const { return block; }
+    };
+
+    class Block
+    {
+        static constexpr uint32_t s_slLog2 = 5;
+        static constexpr uint32_t s_slCount = 1 << s_slLog2;
+        static constexpr uint32_t s_flCount = 64 - s_slLog2 + 1;
+        static constexpr uint32_t s_invalidNode = (std::numeric_limits<uint32_t>::max)();
+
+        struct Node
+        {
+            VkDeviceSize offset;
+            VkDeviceSize size;
+            uint32_t prevPhysical;
+            uint32_t nextPhysical;
+            uint32_t prevFree;
+            uint32_t nextFree;
+            bool free;
+        };
+
+    public:
+        Block(const handles::Device& device,
+            uint32_t memoryTypeIndex,
+            ResourceType resourceType,
+            VkDeviceSize size);
+        Block(const Block& other) = delete;
+        ~Block();
+
+        std::optional<Allocation> allocate(VkDeviceSize size, VkDeviceSize alignment);
+        void free(uint32_t node);
+
+        void* map();
+
+        const handles::Memory& memory() const { return *m_memory; }
+
+        uint32_t memoryTypeIndex() const { return m_memoryTypeIndex; }
+
+        ResourceType resourceType() const { return m_resourceType; }
+
+        VkDeviceSize size() const { return m_size; }
+
+        VkDeviceSize used() const { return m_used; }
+
+        uint32_t allocationCount() const { return m_allocationCount; }
+
+        VkDeviceSize largestFree() const;
+
+        bool isEmpty() const { return m_used == 0; }
+
+    private:
+        static std::pair<uint32_t, uint32_t> mapping(VkDeviceSize size);
+
+        uint32_t findFreeNode(VkDeviceSize size) const;
+        uint32_t createNode(Node node);
+        void releaseNode(uint32_t node);
+        void insertFree(uint32_t node);
+        void removeFree(uint32_t node);
+
+    private:
+        const handles::Device& m_device;
+        const uint32_t m_memoryTypeIndex;
+        const ResourceType m_resourceType;
+        const VkDeviceSize m_size;
+        VkDeviceSize m_used;
+        uint32_t m_allocationCount;
+
+        std::unique_ptr<handles::Memory> m_memory;
+        void* m_mapped;
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_unusedNodes;
+
+        uint64_t m_flBitmap;
+        std::array<uint32_t, s_flCount> m_slBitmaps;
+        std::array<std::array<uint32_t, s_slCount>, s_flCount> m_freeLists;
+    };
+
+    struct HeapStatistics
+    {
+        VkDeviceSize allocated = 0;
+        VkDeviceSize used = 0;
+        VkDeviceSize free = 0;
+        VkDeviceSize largestFree = 0;
+        uint32_t blockCount = 0;
+        uint32_t allocationCount = 0;
+    };
+
+public:
+    static constexpr VkDeviceSize s_defaultBlockSize = 64 * 1024 * 1024;
+
+    //  share of a small (non resizable) bar heap the preferred allocations may take, the driver
+    //  and other applications need the rest
+    static constexpr VkDeviceSize s_smallBarShareDivisor = 2;
+    //  share of the heap budget, so the preferred allocations never push the heap into eviction
+    static constexpr VkDeviceSize s_budgetSharePercent = 80;
+
+public:
+    Allocator(const handles::Device& device);
+    Allocator(const Allocator& other) = delete;
+    ~Allocator();
+
+    std::shared_ptr<handles::Memory> allocate(
+        VkMemoryRequirements requirements, uint32_t memoryTypeIndex, ResourceType resourceType);
+    void free(Allocation allocation);
+
+    std::array<HeapStatistics, VK_MAX_MEMORY_HEAPS> statistics() const;
+
+    //  picks a type with the preferred properties on top of the required ones if one exists and its
+    //  heap can afford the allocation, a type with the required properties otherwise
+    uint32_t findMemoryType(const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags required,
+        VkMemoryPropertyFlags preferred) const;
+
+private:
+    VkDeviceSize blockSize(uint32_t memoryTypeIndex) const;
+    bool isAffordable(uint32_t memoryTypeIndex, VkDeviceSize size) const;
+
+private:
+    const handles::Device& m_device;
+
+    std::array<std::array<std::vector<std::unique_ptr<Block>>, VK_MAX_MEMORY_TYPES>,
+        ResourceType::COUNT>
+        m_blocks;
+};
+
+}    //  namespace renderer::vk
@@ -0,0 +1,131 @@
+#include "bindless_texture_table.hpp"
+
+#include "pipeline.hpp"
+
+#include "handles/descriptor_pool.hpp"
+#include "handles/descriptor_set.hpp"
+#include "handles/descriptor_set_layout.hpp"
+#include "handles/device.hpp"
+
+#include <texture_table.hpp>
+
+#include <algorithm>
+
+namespace renderer::vk {
+
+BindlessTextureTable::BindlessTextureTable(const handles::Device& device)
+    : m_device(device)
+    , m_next(0)
+{
+    VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+    vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &vulkan12Properties;
+    vkGetPhysicalDeviceProperties2(m_device.physicalDevice(), &properties);
+
+    m_capacity = (std::min)({ s_capacity,
+        vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages,
+        vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers,
+        vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+    //  pipelines take this layout for their TextureTable container, so the stage is the one the
+    //  container declares
+    const auto binding =
+        handles::DescriptorSetLayoutBinding{}
+            .binding(s_binding)
+            .descriptorType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+            .descriptorCount(m_capacity)
+            .stageFlags(toShaderStageFlags(TextureTable::s_layout[0].stage));
+
+    //  slots are written while frames using other slots are in flight and most are never written
+    const VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    m_layout = std::make_unique<handles::DescriptorSetLayout>(m_device,
+        handles::DescriptorSetLayoutCreateInfo{}
+            .pNext(&bindingFlagsInfo)
+            .flags(VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT)
+            .bindingCount(1)
+            .pBindings(&binding));
+
+    const auto poolSize =
+        handles::DescriptorPoolSize{}
+            .type(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+            .descriptorCount(m_capacity);
+    m_pool = std::make_unique<handles::DescriptorPool>(m_device,
+        handles::DescriptorPoolCreateInfo{}
+            .flags(VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT)
+            .maxSets(1)
+            .poolSizeCount(1)
+            .pPoolSizes(&poolSize));
+
+    //  lives as long as the pool, never freed on its own
+    m_set = m_pool->tryAllocateTransientSet(*m_layout);
+    ASSERT(m_set, "failed to allocate bindless texture table");
+}
+
+BindlessTextureTable::~BindlessTextureTable()
+{
+    m_set.reset();
+    m_pool.reset();
+    m_layout.reset();
+}
+
+uint32_t BindlessTextureTable::add(const VkDescriptorImageInfo& imageInfo)
+{
+    uint32_t index;
+    if (!m_free.empty())
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        ASSERT(m_next < m_capacity, "bindless texture table is full");
+        index = m_next++;
+    }
+
+    const auto write =
+        handles::WriteDescriptorSet{}
+            .dstSet(*m_set)
+            .dstBinding(s_binding)
+            .dstArrayElement(index)
+            .descriptorCount(1)
+            .descriptorType(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+            .pImageInfo(&imageInfo);
+    m_set->write(std::span{ &write, 1 });
+
+    return index;
+}
+
+void BindlessTextureTable::remove(uint32_t index)
+{
+    DASSERT(index < m_next, "texture is not in the bindless table");
+
+    //  the slot stays written, partially bound arrays only require it to be unused
+    m_removed.push_back(index);
+}
+
+void BindlessTextureTable::record(VkFence fence)
+{
+    if (m_removed.empty()) return;
+
+    m_segments.push(fence, std::move(m_removed));
+    m_removed.clear();
+}
+
+void BindlessTextureTable::release(VkFence fence)
+{
+    m_segments.release(fence, [&](const std::vector<uint32_t>& indices) {
+        m_free.insert(m_free.end(), indices.begin(), indices.end());
+    });
+}
+
+}    //  namespace renderer::vk
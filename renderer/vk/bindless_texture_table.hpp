@@ -0,0 +1,65 @@
+#pragma once
+
+#include "fence_segments.hpp"
+#include "ifenced_resource.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class DescriptorPool;
+class DescriptorSet;
+class DescriptorSetLayout;
+class Device;
+}
+
+//  One partially bound, update after bind array of combined image samplers shared by every
+//  pipeline. Textures take a slot for their lifetime and shaders index the array with it, so
+//  switching textures between draws needs no descriptor set of its own. Freed slots are handed to
+//  the fence of the next submission and become reusable once it has been waited for
+class BindlessTextureTable : public IFencedResource
+{
+public:
+    static constexpr uint32_t s_capacity = 4096;
+    static constexpr uint32_t s_binding = 0;
+
+public:
+    BindlessTextureTable(const handles::Device& device);
+    BindlessTextureTable(const BindlessTextureTable& other) = delete;
+    ~BindlessTextureTable();
+
+    uint32_t add(const VkDescriptorImageInfo& imageInfo);
+    void remove(uint32_t index);
+
+    //  hands the slots removed since the last call to the fence of the submission
+    virtual void record(VkFence fence) override;
+    virtual void release(VkFence fence) override;
+
+    //  slots are bound by draws only
+    virtual bool renderPassOnly() const override { return true; }
+
+    const handles::DescriptorSetLayout& layout() const { return *m_layout; }
+
+    const std::shared_ptr<handles::DescriptorSet>& set() const { return m_set; }
+
+    uint32_t capacity() const { return m_capacity; }
+
+private:
+    const handles::Device& m_device;
+    uint32_t m_capacity;
+
+    std::unique_ptr<handles::DescriptorSetLayout> m_layout;
+    std::unique_ptr<handles::DescriptorPool> m_pool;
+    std::shared_ptr<handles::DescriptorSet> m_set;
+
+    std::vector<uint32_t> m_free;
+    std::vector<uint32_t> m_removed;
+    FenceSegments<std::vector<uint32_t>> m_segments;
+    uint32_t m_next;
+};
+
+}    //  namespace renderer::vk
@@ -1,48 +1,82 @@
 #include "buffer_shader_resource.hpp"
 
-#include <ranges>
+#include <algorithm>
+#include <bit>
 
 namespace renderer::vk {
 
 BufferShaderResource::BufferShaderResource(
-    const handles::Device& device, uint32_t alignment, uint32_t chunkObjectCount)
-    : m_chunkObjectCount(chunkObjectCount)
+    const handles::Device& device, uint32_t alignment, uint32_t initialChunkObjectCount)
+    : m_initialChunkObjectCount(initialChunkObjectCount)
     , m_alignment(alignment)
     , m_device(device)
-{}
+    , m_freeChunkHint(0)
+{
+    DASSERT(initialChunkObjectCount > 0, "chunks have to hold at least one object");
+}
 
 std::shared_ptr<ShaderResource::Descriptor> BufferShaderResource::fetchDescriptor()
 {
-    for (int64_t bufferId = m_buffers.size() - 1; bufferId >= 0; --bufferId)
+    while (m_freeChunkHint < m_chunks.size() && m_chunks[m_freeChunkHint].freeCount == 0)
     {
-        if (auto result = tryFetchDescriptor(bufferId); result)
-        {
-            return result;
-        }
+        ++m_freeChunkHint;
     }
 
-    if (auto result = tryFetchDescriptor(allocateBuffer()); result)
+    const size_t bufferId =
+        m_freeChunkHint < m_chunks.size() ? m_freeChunkHint : allocateBuffer();
+
+    auto descriptor = ShaderResource::fetchDescriptor();
+
+    descriptor->id.descriptorId = occupy(m_chunks[bufferId]);
+    descriptor->id.bufferId = bufferId;
+    descriptor->id.resourceId = id();
+
+    populateDescriptor(*descriptor);
+
+    return descriptor;
+}
+
+size_t BufferShaderResource::allocateBuffer()
+{
+    const uint64_t maxObjectCount = (std::max)(s_maxChunkSize / m_alignment, uint64_t{ 1 });
+    const uint64_t objectCount = (std::min)(
+        m_chunks.empty() ? m_initialChunkObjectCount : uint64_t{ m_chunks.back().objectCount } * 2,
+        maxObjectCount);
+
+    auto& newBuffer = m_buffers.emplaceBack(m_device, bufferCreateInfo(objectCount));
+    newBuffer.allocateAndBindPreferredMemory(memoryProperties(), preferredMemoryProperties())
+        .lock()
+        ->map();
+
+    auto& chunk = m_chunks.emplace_back(Chunk{
+        .objectCount = static_cast<uint32_t>(objectCount),
+        .freeCount = static_cast<uint32_t>(objectCount),
+        .freeWordHint = 0,
+        .occupancy = std::vector<uint64_t>((objectCount + 63) / 64, 0),
+    });
+    if (const uint64_t tail = objectCount % 64; tail)
     {
-        return result;
+        chunk.occupancy.back() = ~uint64_t{ 0 } << tail;
     }
 
-    ASSERT(false, "failed to allocate uniform object");
-    return nullptr;
+    return m_chunks.size() - 1;
 }
 
-size_t BufferShaderResource::allocateBuffer()
+uint64_t BufferShaderResource::occupy(Chunk& chunk)
 {
-    auto& newBuffer = m_buffers.emplaceBack(m_device, bufferCreateInfo());
-    newBuffer.allocateAndBindMemory(memoryProperties()).lock()->map();
-    m_freeDescriptors.push_back(std::unordered_set<uint64_t>{});
-    auto& freeSet = m_freeDescriptors.back();
+    DASSERT(chunk.freeCount, "chunk is full");
 
-    for (uint32_t val : std::views::iota(static_cast<uint32_t>(0), m_chunkObjectCount))
+    while (chunk.occupancy[chunk.freeWordHint] == ~uint64_t{ 0 })
     {
-        freeSet.insert(val);
+        ++chunk.freeWordHint;
     }
 
-    return m_buffers.size() - 1;
+    uint64_t& word = chunk.occupancy[chunk.freeWordHint];
+    const int bit = std::countr_zero(~word);
+    word |= uint64_t{ 1 } << bit;
+    --chunk.freeCount;
+
+    return uint64_t{ chunk.freeWordHint } * 64 + bit;
 }
 
 void BufferShaderResource::populateDescriptor(Descriptor& descriptor)
@@ -56,36 +90,24 @@ void BufferShaderResource::populateDescriptor(Descriptor& descriptor)
     descriptor.memory = buffer.memory();
 }
 
-std::shared_ptr<ShaderResource::Descriptor> BufferShaderResource::tryFetchDescriptor(
-    size_t bufferId)
+void BufferShaderResource::freeDescriptor(const ShaderResource::Descriptor& descriptor)
 {
-    if (auto& freeSet = m_freeDescriptors[bufferId]; !freeSet.empty())
-    {
-        uint64_t freeDescriptorId = freeSet.extract(freeSet.begin()).value();
-
-        auto descriptor = ShaderResource::fetchDescriptor();
+    auto& chunk = m_chunks[descriptor.id.bufferId];
+    const uint32_t wordId = descriptor.id.descriptorId / 64;
 
-        descriptor->id.descriptorId = freeDescriptorId;
-        descriptor->id.bufferId = bufferId;
-        descriptor->id.resourceId = id();
+    DASSERT(chunk.occupancy[wordId] & (uint64_t{ 1 } << descriptor.id.descriptorId % 64),
+        "descriptor is freed twice");
+    chunk.occupancy[wordId] &= ~(uint64_t{ 1 } << descriptor.id.descriptorId % 64);
+    ++chunk.freeCount;
 
-        populateDescriptor(*descriptor);
-
-        return descriptor;
-    }
-
-    return nullptr;
-}
-
-void BufferShaderResource::freeDescriptor(const ShaderResource::Descriptor& descriptor)
-{
-    m_freeDescriptors[descriptor.id.bufferId].insert(descriptor.id.descriptorId);
+    chunk.freeWordHint = (std::min)(chunk.freeWordHint, wordId);
+    m_freeChunkHint = (std::min)(m_freeChunkHint, static_cast<size_t>(descriptor.id.bufferId));
 }
 
-handles::BufferCreateInfo UniformBufferShaderResource::bufferCreateInfo() const
+handles::BufferCreateInfo UniformBufferShaderResource::bufferCreateInfo(uint32_t objectCount) const
 {
     return handles::BufferCreateInfo{}
-        .size(m_alignment * m_chunkObjectCount)
+        .size(uint64_t{ m_alignment } * objectCount)
         .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
         .sharingMode(VK_SHARING_MODE_EXCLUSIVE);
 }
@@ -95,6 +117,13 @@ VkMemoryPropertyFlags UniformBufferShaderResource::memoryProperties() const
     return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
 }
 
+//  written every frame and read by every draw, so it is kept in video memory whenever the host can
+//  write it there directly
+VkMemoryPropertyFlags UniformBufferShaderResource::preferredMemoryProperties() const
+{
+    return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+}
+
 void DynamicUniformBufferShaderResource::populateDescriptor(Descriptor& descriptor)
 {
     auto& buffer = m_buffers[descriptor.id.bufferId];
@@ -109,12 +138,13 @@ void StaticUniformBufferShaderResource::populateDescriptor(Descriptor& descripto
     UniformBufferShaderResource::populateDescriptor(descriptor);
 }
 
-handles::BufferCreateInfo StorageBufferShaderResource::bufferCreateInfo() const
+handles::BufferCreateInfo StorageBufferShaderResource::bufferCreateInfo(uint32_t objectCount) const
 {
     return handles::BufferCreateInfo{}
-        .size(m_alignment * m_chunkObjectCount)
-        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+        .size(uint64_t{ m_alignment } * objectCount)
+        .usage(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT)
         .sharingMode(VK_SHARING_MODE_EXCLUSIVE);
 }
 
@@ -123,4 +153,10 @@ VkMemoryPropertyFlags StorageBufferShaderResource::memoryProperties() const
     return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
 }
 
+//  host writes land in place instead of going through the staging ring
+VkMemoryPropertyFlags StorageBufferShaderResource::preferredMemoryProperties() const
+{
+    return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
 }    //  namespace renderer::vk
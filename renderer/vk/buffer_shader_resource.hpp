@@ -4,34 +4,53 @@
 
 #include "shader_resource.hpp"
 
-#include <map>
-#include <unordered_set>
+#include <vector>
 
 namespace renderer::vk {
 
+//  Objects are suballocated from chunks of a buffer each, every chunk twice as large as the
+//  previous one up to s_maxChunkSize bytes. Free slots are tracked with one occupancy bit per
+//  object, so fetching a slot is a count trailing zeros over the first word with a free bit
 class BufferShaderResource : public ShaderResource
 {
+public:
+    static constexpr uint64_t s_maxChunkSize = 16 * 1024 * 1024;
+
 public:
     BufferShaderResource(
-        const handles::Device& device, uint32_t alignment, uint32_t chunkObjectCount);
+        const handles::Device& device, uint32_t alignment, uint32_t initialChunkObjectCount);
     virtual std::shared_ptr<ShaderResource::Descriptor> fetchDescriptor() override;
 
     uint32_t alignment() const { return m_alignment; }
 
+    size_t chunkCount() const { return m_buffers.size(); }
+
 protected:
     virtual void populateDescriptor(ShaderResource::Descriptor& descriptor);
 
+private:
+    struct Chunk
+    {
+        uint32_t objectCount;
+        uint32_t freeCount;
+        //  lowest word which may have a free bit
+        uint32_t freeWordHint;
+        //  a set bit marks an object in use, bits past objectCount are always set
+        std::vector<uint64_t> occupancy;
+    };
+
 private:
     size_t allocateBuffer();
-    std::shared_ptr<ShaderResource::Descriptor> tryFetchDescriptor(size_t bufferId);
+    uint64_t occupy(Chunk& chunk);
 
     virtual void freeDescriptor(const ShaderResource::Descriptor& descriptor) override;
 
-    virtual handles::BufferCreateInfo bufferCreateInfo() const = 0;
+    virtual handles::BufferCreateInfo bufferCreateInfo(uint32_t objectCount) const = 0;
     virtual VkMemoryPropertyFlags memoryProperties() const = 0;
+    virtual VkMemoryPropertyFlags preferredMemoryProperties() const = 0;
 
 protected:
-    const uint32_t m_chunkObjectCount;
+    const uint32_t m_initialChunkObjectCount;
     const uint32_t m_alignment;
 
 protected:
@@ -40,7 +59,9 @@ protected:
 private:
     const handles::Device& m_device;
 
-    std::vector<std::unordered_set<uint64_t>> m_freeDescriptors;
+    std::vector<Chunk> m_chunks;
+    //  every chunk before it is full
+    size_t m_freeChunkHint;
 };
 
 class UniformBufferShaderResource : public BufferShaderResource
@@ -49,8 +70,9 @@ public:
     using BufferShaderResource::BufferShaderResource;
 
 private:
-    virtual handles::BufferCreateInfo bufferCreateInfo() const override;
+    virtual handles::BufferCreateInfo bufferCreateInfo(uint32_t objectCount) const override;
     virtual VkMemoryPropertyFlags memoryProperties() const override;
+    virtual VkMemoryPropertyFlags preferredMemoryProperties() const override;
 };
 
 class DynamicUniformBufferShaderResource : public UniformBufferShaderResource
@@ -77,8 +99,9 @@ public:
     using BufferShaderResource::BufferShaderResource;
 
 private:
-    virtual handles::BufferCreateInfo bufferCreateInfo() const override;
+    virtual handles::BufferCreateInfo bufferCreateInfo(uint32_t objectCount) const override;
     virtual VkMemoryPropertyFlags memoryProperties() const override;
+    virtual VkMemoryPropertyFlags preferredMemoryProperties() const override;
 };
 
 }    //  namespace renderer::vk
@@ -0,0 +1,112 @@
+#include "command_bundle.hpp"
+
+#include "ispecific_operation_target.hpp"
+#include "secondary_recorder.hpp"
+#include "transient_descriptor_allocator.hpp"
+#include "uniform_arena.hpp"
+
+#include "handles/command_buffer.hpp"
+#include "handles/device.hpp"
+#include "handles/render_pass.hpp"
+
+#include <operation_context.hpp>
+
+#include <cstring>
+
+namespace renderer::vk {
+
+namespace {
+
+template <typename T>
+bool equal(const std::optional<T>& lhs, const std::optional<T>& rhs)
+{
+    if (lhs.has_value() != rhs.has_value()) return false;
+
+    return !lhs || std::memcmp(&*lhs, &*rhs, sizeof(T)) == 0;
+}
+
+}    //  namespace
+
+CommandBundle::CommandBundle(const handles::Device& device)
+    : m_device(device)
+{}
+
+CommandBundle::~CommandBundle()
+{
+    invalidate();
+}
+
+void CommandBundle::invalidate()
+{
+    if (!m_commandBuffer) return;
+
+    //  the last submissions executing it may still be in flight
+    m_device.secondaryRecorder().retire(std::move(m_commandBuffer));
+    m_transient = false;
+}
+
+bool CommandBundle::valid() const
+{
+    return m_commandBuffer != nullptr;
+}
+
+VkCommandBuffer CommandBundle::prepare(renderer::OperationContext& context,
+    const RecordFunction& record)
+{
+    auto& specContext = get(context);
+    DASSERT(specContext.secondaryContents, "bundles are executed as secondary command buffers");
+
+    if (m_transient || m_renderPass != specContext.renderPass->handle() ||
+        !equal(m_viewport, specContext.viewport) || !equal(m_scissor, specContext.scissor))
+    {
+        invalidate();
+    }
+
+    if (m_commandBuffer) return *m_commandBuffer;
+
+    m_commandBuffer = m_device.secondaryRecorder().acquireCached();
+    m_renderPass = specContext.renderPass->handle();
+    m_viewport = specContext.viewport;
+    m_scissor = specContext.scissor;
+
+    //  no framebuffer is given, the swapchain images have one each
+    const auto inheritanceInfo =
+        handles::CommandBufferInheritanceInfo{}
+            .renderPass(m_renderPass)
+            .subpass(0)
+            .framebuffer(VK_NULL_HANDLE);
+    //  frames in flight execute the same buffer
+    const auto beginInfo =
+        handles::CommandBufferBeginInfo{}
+            .flags(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT)
+            .pInheritanceInfo(&inheritanceInfo);
+    ASSERT(m_commandBuffer->begin(beginInfo) == VK_SUCCESS,
+        "failed to begin recording command bundle!");
+
+    renderer::OperationContext bundleContext;
+    auto& bundleSpecContext = bundleContext.emplace<vk::OperationContext>(specContext.renderer);
+    bundleSpecContext.framebuffer = specContext.framebuffer;
+    bundleSpecContext.renderPass = specContext.renderPass;
+    bundleSpecContext.specificTarget = specContext.specificTarget;
+    bundleSpecContext.mainTarget = specContext.mainTarget;
+    bundleSpecContext.commandBuffer = m_commandBuffer.get();
+
+    if (m_viewport) m_commandBuffer->setViewport(*m_viewport);
+    if (m_scissor) m_commandBuffer->setScissor(*m_scissor);
+
+    const uint64_t arenaUses = m_device.uniformArena().useCount();
+    auto& transientSets = specContext.specificTarget->transientDescriptorAllocator();
+    const uint64_t transientSetUses = transientSets.useCount();
+
+    record(bundleContext);
+
+    m_transient = arenaUses != m_device.uniformArena().useCount() ||
+        transientSetUses != transientSets.useCount();
+
+    ASSERT(m_commandBuffer->end() == VK_SUCCESS, "failed to record command bundle!");
+
+    return *m_commandBuffer;
+}
+
+}    //  namespace renderer::vk
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <icommand_bundle.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+
+namespace renderer {
+
+class OperationContext;
+
+namespace vk {
+
+namespace handles {
+class CommandBuffer;
+class Device;
+}
+
+//  A secondary command buffer executed by every replay until it is invalidated. It is recorded
+//  again for a different render pass, viewport or scissor. Commands reading memory of a single
+//  submission, slices of the uniform arena or transient descriptor sets, make the recording valid
+//  for the operation it was made in only. Buffers that are dropped are retired to the secondary
+//  recorder, which reuses them once the submissions executing them have been waited for
+class CommandBundle : public ICommandBundle
+{
+public:
+    using RecordFunction = std::function<void(renderer::OperationContext&)>;
+
+public:
+    CommandBundle(const handles::Device& device);
+    CommandBundle(const CommandBundle& other) = delete;
+    ~CommandBundle();
+
+    virtual void invalidate() override;
+    virtual bool valid() const override;
+
+    //  records the bundle for the render pass and dynamic state of the context unless it holds
+    //  such a recording already, the context has to be started with secondary contents
+    VkCommandBuffer prepare(renderer::OperationContext& context, const RecordFunction& record);
+
+private:
+    const handles::Device& m_device;
+
+    std::unique_ptr<handles::CommandBuffer> m_commandBuffer;
+    VkRenderPass m_renderPass = VK_NULL_HANDLE;
+    std::optional<VkViewport> m_viewport;
+    std::optional<VkRect2D> m_scissor;
+    //  recorded with data of a single submission, dropped by the next prepare
+    bool m_transient = false;
+};
+
+}    //  namespace vk
+
+}    //  namespace renderer
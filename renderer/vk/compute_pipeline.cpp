@@ -20,15 +20,12 @@ void ComputePipeline::BindContext::bind(renderer::OperationContext& context,
     Pipeline::BindContext::bind(context, container);
     auto& specContext = get(context);
 
-    std::vector<uint32_t> offsets;
-    for (auto& descriptor : container.dynamicUniforms())
+    pushConstants(*specContext.commandBuffer, specContext.computePipeline->layout());
+    if (currentSet)
     {
-        descriptor.handle.lock()->accept(s_handleVisitor);
-        offsets.push_back(s_handleVisitor->currentDescriptor()->dynamicOffset);
+        specContext.commandBuffer->bindDescriptorSet(specContext.computePipeline->layout(),
+            descriptorSetInfo.setId, currentSet, dynamicOffsets(), VK_PIPELINE_BIND_POINT_COMPUTE);
     }
-
-    specContext.commandBuffer->bindDescriptorSet(specContext.computePipeline->layout(),
-        descriptorSetInfo.setId, currentSet, offsets, VK_PIPELINE_BIND_POINT_COMPUTE);
 }
 
 ComputePipelineCreateInfo ComputePipeline::defaultPipeline()
@@ -0,0 +1,81 @@
+#include "deletion_queue.hpp"
+
+#include "handles/device.hpp"
+#include "upload_manager.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace renderer::vk {
+
+DeletionQueue::DeletionQueue(const handles::Device& device)
+    : m_device(device)
+{}
+
+DeletionQueue::~DeletionQueue()
+{
+    //  destructions may retire further objects, like allocator blocks left empty
+    for (;;)
+    {
+        std::vector<Deleter> deleters;
+        {
+            std::lock_guard lock(m_mutex);
+            m_segments.releaseAll([&](Deleters& retired) {
+                std::move(retired.deleters.begin(), retired.deleters.end(),
+                    std::back_inserter(deleters));
+            });
+            std::move(m_pending.begin(), m_pending.end(), std::back_inserter(deleters));
+            m_pending.clear();
+        }
+
+        if (deleters.empty()) return;
+
+        for (auto& deleter : deleters)
+        {
+            deleter();
+        }
+    }
+}
+
+void DeletionQueue::retire(Deleter deleter)
+{
+    std::lock_guard lock(m_mutex);
+    m_pending.push_back(std::move(deleter));
+}
+
+void DeletionQueue::record(VkFence fence)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_pending.empty()) return;
+
+    m_segments.push(fence,
+        Deleters{ .uploadToken = m_device.uploadManager().lastToken(),
+            .deleters = std::move(m_pending) });
+    m_pending.clear();
+}
+
+void DeletionQueue::release(VkFence fence)
+{
+    std::vector<Deleter> deleters;
+    uint64_t uploadToken = 0;
+    {
+        std::lock_guard lock(m_mutex);
+        m_segments.release(fence, [&](Deleters& retired) {
+            std::move(retired.deleters.begin(), retired.deleters.end(),
+                std::back_inserter(deleters));
+            uploadToken = (std::max)(uploadToken, retired.uploadToken);
+        });
+    }
+
+    //  the transfer queue isn't ordered with the submission, uploads recorded while it was
+    //  recorded may still copy into the objects. They are done by now in all but rare cases
+    if (!deleters.empty()) m_device.uploadManager().wait(uploadToken);
+
+    //  run unlocked, they may retire objects of their own
+    for (auto& deleter : deleters)
+    {
+        deleter();
+    }
+}
+
+}    //  namespace renderer::vk
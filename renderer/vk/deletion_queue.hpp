@@ -0,0 +1,55 @@
+#pragma once
+
+#include "fence_segments.hpp"
+#include "ifenced_resource.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class Device;
+}
+
+//  Defers destruction of GPU objects submissions in flight may still read. Destructions retired
+//  since the last record are handed to the fence of that submission and run once it has been
+//  waited for. Submissions to a queue complete in order, so every one in flight when an object was
+//  retired is done by then. Uploads run on a queue of their own, so destructions wait for the
+//  uploads recorded up to the submission as well. Objects are retired from worker threads and by
+//  running destructions
+class DeletionQueue : public IFencedResource
+{
+public:
+    using Deleter = std::function<void()>;
+
+public:
+    DeletionQueue(const handles::Device& device);
+    DeletionQueue(const DeletionQueue& other) = delete;
+    //  runs every destruction left, the device has to be idle
+    ~DeletionQueue();
+
+    void retire(Deleter deleter);
+
+    //  hands the destructions retired since the last call to the fence of the submission
+    virtual void record(VkFence fence) override;
+    virtual void release(VkFence fence) override;
+
+private:
+    struct Deleters
+    {
+        uint64_t uploadToken;
+        std::vector<Deleter> deleters;
+    };
+
+private:
+    const handles::Device& m_device;
+    std::mutex m_mutex;
+    std::vector<Deleter> m_pending;
+    FenceSegments<Deleters> m_segments;
+};
+
+}    //  namespace renderer::vk
@@ -0,0 +1,96 @@
+#include "descriptor_set_cache.hpp"
+
+#include "handles/descriptor_set.hpp"
+
+#include <algorithm>
+
+namespace renderer::vk {
+
+static size_t hashCombine(size_t seed, uint64_t value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+void DescriptorSetKey::push(const ShaderResource::Descriptor::Id& id)
+{
+    DASSERT(m_size < s_capacity, "too many descriptors in a set");
+
+    m_ids[m_size++] = id;
+    m_hash = hashCombine(hashCombine(hashCombine(m_hash, id.resourceId), id.bufferId),
+        id.descriptorId);
+}
+
+void DescriptorSetKey::clear()
+{
+    m_size = 0;
+    m_hash = 0;
+}
+
+bool DescriptorSetKey::operator==(const DescriptorSetKey& other) const
+{
+    return m_hash == other.m_hash && m_size == other.m_size &&
+        std::equal(m_ids.begin(), m_ids.begin() + m_size, other.m_ids.begin());
+}
+
+std::shared_ptr<handles::DescriptorSet>* DescriptorSetCache::find(const DescriptorSetKey& key)
+{
+    if (m_slots.empty()) return nullptr;
+
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = key.hash() & mask;; i = (i + 1) & mask)
+    {
+        const auto& slot = m_slots[i];
+        if (slot.entry == s_emptySlot) return nullptr;
+
+        if (slot.hash == key.hash() && m_entries[slot.entry - 1].key == key)
+        {
+            return &m_entries[slot.entry - 1].set;
+        }
+    }
+}
+
+std::shared_ptr<handles::DescriptorSet>& DescriptorSetCache::insert(
+    const DescriptorSetKey& key, std::shared_ptr<handles::DescriptorSet> set)
+{
+    DASSERT(!find(key), "descriptor set key is already cached");
+
+    //  keeps the load factor at or below 1/2, so probe sequences stay short
+    if ((m_entries.size() + 1) * 2 > m_slots.size())
+    {
+        rehash((std::max)(s_initialCapacity, m_slots.size() * 2));
+    }
+
+    m_entries.push_back(Entry{ .key = key, .set = std::move(set) });
+
+    const size_t mask = m_slots.size() - 1;
+    size_t i = key.hash() & mask;
+    while (m_slots[i].entry != s_emptySlot) i = (i + 1) & mask;
+
+    m_slots[i] = Slot{ .hash = key.hash(), .entry = static_cast<uint32_t>(m_entries.size()) };
+
+    return m_entries.back().set;
+}
+
+void DescriptorSetCache::clear()
+{
+    std::fill(m_slots.begin(), m_slots.end(), Slot{ .hash = 0, .entry = s_emptySlot });
+    m_entries.clear();
+}
+
+void DescriptorSetCache::rehash(size_t capacity)
+{
+    m_slots.assign(capacity, Slot{ .hash = 0, .entry = s_emptySlot });
+
+    const size_t mask = capacity - 1;
+    for (uint32_t entry = 0; entry < m_entries.size(); ++entry)
+    {
+        const size_t hash = m_entries[entry].key.hash();
+
+        size_t i = hash & mask;
+        while (m_slots[i].entry != s_emptySlot) i = (i + 1) & mask;
+
+        m_slots[i] = Slot{ .hash = hash, .entry = entry + 1 };
+    }
+}
+
+}    //  namespace renderer::vk
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "shader_resource.hpp"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class DescriptorSet;
+}
+
+//  Ids of the descriptors bound to a set, stored inline. The hash is accumulated while the key is
+//  built, so a lookup never walks the ids again unless the hashes match
+class DescriptorSetKey
+{
+public:
+    static constexpr size_t s_capacity = 16;
+
+public:
+    void push(const ShaderResource::Descriptor::Id& id);
+    void clear();
+
+    size_t hash() const { return m_hash; }
+
+    size_t size() const { return m_size; }
+
+    bool operator==(const DescriptorSetKey& other) const;
+
+private:
+    std::array<ShaderResource::Descriptor::Id, s_capacity> m_ids;
+    uint32_t m_size = 0;
+    size_t m_hash = 0;
+};
+
+//  Open addressing map from descriptor keys to sets. The probed slots only hold the hash and the
+//  index of the entry, so probing stays within a few cache lines. Entries are never erased one by
+//  one, the whole cache is cleared instead
+class DescriptorSetCache
+{
+public:
+    std::shared_ptr<handles::DescriptorSet>* find(const DescriptorSetKey& key);
+    std::shared_ptr<handles::DescriptorSet>& insert(
+        const DescriptorSetKey& key, std::shared_ptr<handles::DescriptorSet> set);
+    void clear();
+
+    size_t size() const { return m_entries.size(); }
+
+private:
+    static constexpr uint32_t s_emptySlot = 0;
+    static constexpr size_t s_initialCapacity = 16;
+
+    struct Slot
+    {
+        size_t hash;
+        //  index of the entry plus one, s_emptySlot if unused
+        uint32_t entry;
+    };
+
+    struct Entry
+    {
+        DescriptorSetKey key;
+        std::shared_ptr<handles::DescriptorSet> set;
+    };
+
+    void rehash(size_t capacity);
+
+private:
+    std::vector<Slot> m_slots;
+    std::vector<Entry> m_entries;
+};
+
+}    //  namespace renderer::vk
@@ -2,6 +2,10 @@
 
 #include "graphics_context.hpp"
 
+#include "handles/descriptor_set_layout.hpp"
+
+#include <algorithm>
+
 namespace renderer::vk {
 
 DescriptorSetProvider::DescriptorSetProvider(const GraphicsContext& context,
@@ -11,6 +15,7 @@ DescriptorSetProvider::DescriptorSetProvider(const GraphicsContext& context,
     , m_pivotPoolCount(pivotPoolCount)
     , m_poolMaxSetCount(poolCreateInfo.maxSets())
     , m_poolFlags(poolCreateInfo.flags())
+    , m_reserveLayout(VK_NULL_HANDLE)
 {
     m_poolSizes.resize(poolCreateInfo.poolSizeCount());
     std::copy(poolCreateInfo.pPoolSizes(),
@@ -19,47 +24,119 @@ DescriptorSetProvider::DescriptorSetProvider(const GraphicsContext& context,
 
     for (size_t i = 0; i < pivotPoolCount; ++i)
     {
-        m_poolList.emplace_back(context.device(), poolCreateInfo);
+        createPool();
+    }
+
+    m_currentPool = m_poolList.begin();
+    for (auto iter = std::next(m_poolList.begin()); iter != m_poolList.end(); ++iter)
+    {
+        m_availablePools.push_back(iter);
     }
 }
 
-DescriptorSetProvider::~DescriptorSetProvider() {}
+DescriptorSetProvider::~DescriptorSetProvider()
+{
+    m_reserve.clear();
+    m_availablePools.clear();
+    m_poolList.clear();
+}
 
 std::shared_ptr<handles::DescriptorSet> DescriptorSetProvider::set(
     const handles::DescriptorSetLayout& layout)
 {
-    for (auto iter = m_poolList.begin(); iter != m_poolList.end();)
+    if (m_reserveLayout != layout.handle())
     {
-        if (iter->isFull())
-        {
-            ++iter;
-            continue;
-        } 
+        m_reserve.clear();
+        m_reserveLayout = layout.handle();
+    }
+
+    if (m_reserve.empty())
+    {
+        const std::vector<VkDescriptorSetLayout> layouts(
+            (std::min)(s_reserveSize, m_poolMaxSetCount), layout.handle());
+        m_reserve = sets(std::span<const VkDescriptorSetLayout>{ layouts });
+        std::reverse(m_reserve.begin(), m_reserve.end());
+    }
+
+    auto result = std::move(m_reserve.back());
+    m_reserve.pop_back();
+
+    return result;
+}
+
+std::vector<std::shared_ptr<handles::DescriptorSet>> DescriptorSetProvider::sets(
+    std::span<const handles::DescriptorSetLayout> layouts)
+{
+    std::vector<VkDescriptorSetLayout> vkLayouts;
+    vkLayouts.reserve(layouts.size());
+    for (const auto& layout : layouts)
+    {
+        vkLayouts.push_back(layout.handle());
+    }
+
+    return sets(std::span<const VkDescriptorSetLayout>{ vkLayouts });
+}
+
+std::vector<std::shared_ptr<handles::DescriptorSet>> DescriptorSetProvider::sets(
+    std::span<const VkDescriptorSetLayout> layouts)
+{
+    std::vector<std::shared_ptr<handles::DescriptorSet>> result;
+    result.reserve(layouts.size());
+
+    //  one allocation call per pool the request spans
+    while (result.size() < layouts.size())
+    {
+        auto& pool = currentPool();
+        const size_t count =
+            (std::min)(static_cast<size_t>(pool.freeSetCount()), layouts.size() - result.size());
+
+        auto batch = pool.allocateSets(layouts.subspan(result.size(), count));
+        std::move(batch.begin(), batch.end(), std::back_inserter(result));
+    }
+
+    return result;
+}
+
+handles::DescriptorPool& DescriptorSetProvider::currentPool()
+{
+    if (!m_currentPool->isFull()) return *m_currentPool;
 
+    while (!m_availablePools.empty())
+    {
+        const auto iter = m_availablePools.back();
+        m_availablePools.pop_back();
+
+        //  pools above the pivot count are released once they are not used anymore
         if (iter->isEmpty() && m_poolList.size() > m_pivotPoolCount)
         {
-            iter = m_poolList.erase(iter);
-			continue;
+            m_poolList.erase(iter);
+            continue;
         }
 
-        return iter->allocateSet(layout);
+        m_currentPool = iter;
+        return *m_currentPool;
     }
 
+    m_currentPool = createPool();
+    return *m_currentPool;
+}
+
+DescriptorSetProvider::PoolIterator DescriptorSetProvider::createPool()
+{
     m_poolList.emplace_back(m_context.device(),
         handles::DescriptorPoolCreateInfo{}
             .flags(m_poolFlags)
             .pPoolSizes(m_poolSizes.data())
             .poolSizeCount(m_poolSizes.size())
             .maxSets(m_poolMaxSetCount));
-    return m_poolList.back().allocateSet(layout);
-}
 
-std::shared_ptr<handles::DescriptorSet> DescriptorSetProvider::sets(
-    std::span<const handles::DescriptorSetLayout> layout)
-{
-    ASSERT(false, "not implemented");
-    return nullptr;
-}
+    const auto iter = std::prev(m_poolList.end());
+    iter->setAvailableCallback([this, iter]() {
+        //  the current pool is picked up again anyway once it is checked for space
+        if (iter != m_currentPool) m_availablePools.push_back(iter);
+    });
 
+    return iter;
+}
 
 }    //  namespace renderer::vk
@@ -4,22 +4,39 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace renderer::vk {
 
 class GraphicsContext;
 
+//  Hands out descriptor sets from a growing list of pools. Allocations go to the current pool,
+//  once it is full the next one is taken from the pools which got sets freed in the meantime or a
+//  new pool is created, so no allocation ever scans the pool list
 class DescriptorSetProvider
 {
+public:
+    //  sets allocated ahead by set() with a single call, bounded by the pool size
+    static constexpr uint32_t s_reserveSize = 16;
+
 public:
     DescriptorSetProvider(const GraphicsContext& context,
         handles::DescriptorPoolCreateInfo poolCreateInfo,
         uint32_t pivotPoolCount = 1);
+    DescriptorSetProvider(const DescriptorSetProvider& other) = delete;
     ~DescriptorSetProvider();
 
     std::shared_ptr<handles::DescriptorSet> set(const handles::DescriptorSetLayout& layout);
-    std::shared_ptr<handles::DescriptorSet> sets(
-        std::span<const handles::DescriptorSetLayout> layout);
+    std::vector<std::shared_ptr<handles::DescriptorSet>> sets(
+        std::span<const handles::DescriptorSetLayout> layouts);
+    std::vector<std::shared_ptr<handles::DescriptorSet>> sets(
+        std::span<const VkDescriptorSetLayout> layouts);
+
+private:
+    using PoolIterator = std::list<handles::DescriptorPool>::iterator;
+
+    handles::DescriptorPool& currentPool();
+    PoolIterator createPool();
 
 private:
     const GraphicsContext& m_context;
@@ -29,6 +46,12 @@ private:
     std::vector<handles::DescriptorPoolSize> m_poolSizes;
 
     std::list<handles::DescriptorPool> m_poolList;
+    PoolIterator m_currentPool;
+    //  pools which got sets freed after they had been full
+    std::vector<PoolIterator> m_availablePools;
+
+    VkDescriptorSetLayout m_reserveLayout;
+    std::vector<std::shared_ptr<handles::DescriptorSet>> m_reserve;
 };
 
 }    //  namespace renderer::vk
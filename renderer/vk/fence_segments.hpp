@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <deque>
+#include <utility>
+
+namespace renderer::vk {
+
+//  What submissions use, kept in record order along with their fences until these have been
+//  waited for. Pools take back the segments of a fence whatever was recorded before, rings reuse
+//  their space in record order and take segments back from the oldest one only
+template <typename Payload>
+class FenceSegments
+{
+public:
+    struct Segment
+    {
+        VkFence fence;
+        Payload payload;
+        bool done;
+    };
+
+public:
+    void push(VkFence fence, Payload payload)
+    {
+        m_segments.push_back(
+            Segment{ .fence = fence, .payload = std::move(payload), .done = false });
+    }
+
+    //  hands the payloads recorded with the fence to take
+    template <typename Take>
+    void release(VkFence fence, Take&& take)
+    {
+        for (auto iter = m_segments.begin(); iter != m_segments.end();)
+        {
+            if (iter->fence != fence)
+            {
+                ++iter;
+                continue;
+            }
+
+            take(iter->payload);
+            iter = m_segments.erase(iter);
+        }
+    }
+
+    //  marks the segments matching done as such and hands the done ones up to the oldest one still
+    //  pending to take
+    template <typename Predicate, typename Take>
+    void releaseInOrderIf(Predicate&& done, Take&& take)
+    {
+        for (auto& segment : m_segments)
+        {
+            if (done(segment)) segment.done = true;
+        }
+
+        while (!m_segments.empty() && m_segments.front().done)
+        {
+            take(m_segments.front().payload);
+            m_segments.pop_front();
+        }
+    }
+
+    template <typename Take>
+    void releaseInOrder(VkFence fence, Take&& take)
+    {
+        releaseInOrderIf([fence](const Segment& segment) { return segment.fence == fence; },
+            std::forward<Take>(take));
+    }
+
+    //  hands every payload to take, for owners outliving the submissions
+    template <typename Take>
+    void releaseAll(Take&& take)
+    {
+        for (auto& segment : m_segments)
+        {
+            take(segment.payload);
+        }
+        m_segments.clear();
+    }
+
+    void clear() { m_segments.clear(); }
+
+    bool empty() const { return m_segments.empty(); }
+
+    const Segment& front() const { return m_segments.front(); }
+
+private:
+    std::deque<Segment> m_segments;
+};
+
+}    //  namespace renderer::vk
@@ -2,6 +2,8 @@
 
 #include "handles/surface.hpp"
 #include "handles/memory.hpp"
+#include "allocator.hpp"
+#include "command_bundle.hpp"
 #include "compute_pipeline.hpp"
 #include "graphics_pipeline.hpp"
 #include "computer.hpp"
@@ -172,30 +174,38 @@ std::weak_ptr<vk::handles::Memory> GraphicsContext::fetchMemory(
 std::shared_ptr<ShaderInterfaceHandle> GraphicsContext::fetchHandleSpecific(ShaderBlockType sbt,
     uint32_t layoutSize)
 {
+    if (sbt == ShaderBlockType::PUSH_CONSTANT)
+    {
+        return ShaderInterfaceHandle::createPushConstant(layoutSize);
+    }
+
     const uint32_t alignment = dynamicAlignment(layoutSize);
 
-    auto insertAndFetchSpecificHandle = [&](auto& map) {
-        if (auto el = map.find(layoutSize); el != map.end())
+    auto insertAndFetchResource = [&](auto& map) -> auto& {
+        if (auto el = map.find(alignment); el != map.end())
         {
-            return ShaderInterfaceHandle::create(el->second);
+            return el->second;
         }
         using PairType = typename std::remove_reference<decltype(map)>::type::value_type;
-        auto [iter, _] = map.emplace(
-            PairType{ alignment, typename PairType::second_type{ device(), alignment, 100 } });
+        auto [iter, _] = map.emplace(PairType{ alignment,
+            typename PairType::second_type{ device(), alignment, m_initialChunkObjectCount } });
 
-        return ShaderInterfaceHandle::create(iter->second);
+        return iter->second;
     };
 
     if (sbt == ShaderBlockType::STORAGE)
     {
-        return insertAndFetchSpecificHandle(m_storageShaderResources);
+        return ShaderInterfaceHandle::create(insertAndFetchResource(m_storageShaderResources));
     }
     else if (sbt == ShaderBlockType::UNIFORM_DYNAMIC)
     {
-        return insertAndFetchSpecificHandle(m_dynamicUniformShaderResources);
+        //  the pooled slot only holds data which stopped changing
+        return ShaderInterfaceHandle::createArena(
+            insertAndFetchResource(m_dynamicUniformShaderResources), device().uniformArena(),
+            layoutSize);
     }
 
-    return insertAndFetchSpecificHandle(m_staticUniformShaderResources);
+    return ShaderInterfaceHandle::create(insertAndFetchResource(m_staticUniformShaderResources));
 }
 
 std::shared_ptr<IShaderInterfaceHandle> GraphicsContext::fetchHandle(ShaderBlockType sbt,
@@ -311,6 +321,11 @@ std::shared_ptr<ITexture> GraphicsContext::createTexture(ITexture::CreateInfo cr
     return std::make_shared<Texture>(*this, std::move(createInfo));
 }
 
+std::shared_ptr<ICommandBundle> GraphicsContext::createCommandBundle()
+{
+    return std::make_shared<CommandBundle>(*m_device);
+}
+
 void GraphicsContext::waitIdle()
 {
     m_device->waitIdle();
@@ -349,4 +364,56 @@ Multisampling GraphicsContext::maxSampleCount() const
     return Multisampling::MSA_1X;
 }
 
+MemoryStatistics GraphicsContext::memoryStatistics() const
+{
+    MemoryStatistics result;
+
+    const auto allocatorStatistics = m_device->allocator().statistics();
+    const auto budget = m_device->memoryBudget();
+    for (uint32_t i = 0; i < m_device->memoryHeapCount(); ++i)
+    {
+        const auto& heapStatistics = allocatorStatistics[i];
+        const VkMemoryHeap heap = m_device->memoryHeap(i);
+
+        result.heaps.push_back(MemoryStatistics::Heap{
+            .deviceLocal = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+            .size = heap.size,
+            .budget = budget.has_value() ? budget->heapBudget[i] : 0,
+            .usage = budget.has_value() ? budget->heapUsage[i] : 0,
+            .allocated = heapStatistics.allocated,
+            .used = heapStatistics.used,
+            .blockCount = heapStatistics.blockCount,
+            .allocationCount = heapStatistics.allocationCount,
+            .fragmentation = heapStatistics.free ?
+                1.0f - static_cast<float>(heapStatistics.largestFree) / heapStatistics.free :
+                0.0f,
+        });
+    }
+
+    result.bufferCount = m_device->objectCount(handles::ObjectCounter::BUFFER);
+    result.imageCount = m_device->objectCount(handles::ObjectCounter::IMAGE);
+    result.descriptorPoolCount = m_device->objectCount(handles::ObjectCounter::DESCRIPTOR_POOL);
+
+    auto countChunks = [&result](const auto& resources) {
+        for (const auto& [_, resource] : resources)
+        {
+            result.uniformChunkCount += resource.chunkCount();
+        }
+    };
+    countChunks(m_staticUniformShaderResources);
+    countChunks(m_dynamicUniformShaderResources);
+
+    return result;
+}
+
+CommandStatistics GraphicsContext::commandStatistics() const
+{
+    return m_device->commandStatistics();
+}
+
+bool GraphicsContext::indirectFirstInstanceSupported() const
+{
+    return m_device->drawIndirectFirstInstanceSupported();
+}
+
 }    //  namespace renderer::vk
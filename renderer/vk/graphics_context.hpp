@@ -34,6 +34,7 @@ class GraphicsContext
 public:
     const static bool s_enableValidationLayers;
     const static std::vector<const char*> s_validationLayers;
+    static constexpr uint32_t s_defaultChunkObjectCount = 64;
 
 public:
     GraphicsContext(handles::InstanceCreateInfo instanceCreateInfo);
@@ -53,6 +54,11 @@ public:
         uint32_t layoutSize);
     virtual std::shared_ptr<IShaderInterfaceHandle> fetchHandle(ShaderBlockType sbt,
         uint32_t layoutSize) override;
+    //  object count of the first chunk of shader resources created afterwards, later chunks grow
+    void setInitialChunkObjectCount(uint32_t objectCount)
+    {
+        m_initialChunkObjectCount = objectCount;
+    }
 
     std::shared_ptr<ISwapchain> createSwapchain(IVulkanSurface& surface,
         ISwapchain::CreateInfo createInfo);
@@ -69,10 +75,15 @@ public:
     virtual std::shared_ptr<IModel> createModel(IModel::CreateInfo createInfo) override;
     virtual std::shared_ptr<ITexture> createTexture(std::filesystem::path path) override;
     virtual std::shared_ptr<ITexture> createTexture(ITexture::CreateInfo createInfo) override;
+    virtual std::shared_ptr<ICommandBundle> createCommandBundle() override;
 
     virtual void waitIdle() override;
 
     virtual Multisampling maxSampleCount() const override;
+    virtual bool indirectFirstInstanceSupported() const override;
+
+    virtual MemoryStatistics memoryStatistics() const override;
+    virtual CommandStatistics commandStatistics() const override;
 
     const handles::Device& device() const;
 
@@ -92,6 +103,7 @@ private:
     std::unordered_map<uint32_t, DynamicUniformBufferShaderResource>
         m_dynamicUniformShaderResources;
     std::unordered_map<uint32_t, StorageBufferShaderResource> m_storageShaderResources;
+    uint32_t m_initialChunkObjectCount = s_defaultChunkObjectCount;
 
     std::unique_ptr<handles::Device> m_device;
     std::unique_ptr<handles::DebugUtilsMessenger> m_debugMessenger;
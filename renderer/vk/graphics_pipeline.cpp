@@ -81,7 +81,11 @@ VkPrimitiveTopology toVkPrimitiveTopology(IGraphicsPipeline::CreateInfo::Primiti
 
 VkVertexInputRate toVkInputRate(IGraphicsPipeline::CreateInfo::Binding::Rate rate)
 {
-    if (rate == IGraphicsPipeline::CreateInfo::Binding::VERTEX) return VK_VERTEX_INPUT_RATE_VERTEX;
+    switch (rate)
+    {
+        case IGraphicsPipeline::CreateInfo::Binding::VERTEX: return VK_VERTEX_INPUT_RATE_VERTEX;
+        case IGraphicsPipeline::CreateInfo::Binding::INSTANCE: return VK_VERTEX_INPUT_RATE_INSTANCE;
+    }
     ASSERT(false, "not implemented");
     return VK_VERTEX_INPUT_RATE_MAX_ENUM;
 }
@@ -106,15 +110,12 @@ void GraphicsPipeline::BindContext::bind(renderer::OperationContext& context,
     Pipeline::BindContext::bind(context, container);
     auto& specContext = get(context);
 
-    std::vector<uint32_t> offsets;
-    for (auto& descriptor : container.dynamicUniforms())
+    pushConstants(*specContext.commandBuffer, specContext.graphicsPipeline->layout());
+    if (currentSet)
     {
-        descriptor.handle.lock()->accept(s_handleVisitor);
-        offsets.push_back(s_handleVisitor->currentDescriptor()->dynamicOffset);
+        specContext.commandBuffer->bindDescriptorSet(specContext.graphicsPipeline->layout(),
+            descriptorSetInfo.setId, currentSet, dynamicOffsets(), VK_PIPELINE_BIND_POINT_GRAPHICS);
     }
-
-    specContext.commandBuffer->bindDescriptorSet(specContext.graphicsPipeline->layout(),
-        descriptorSetInfo.setId, currentSet, offsets, VK_PIPELINE_BIND_POINT_GRAPHICS);
 }
 
 GraphicsPipelineCreateInfo GraphicsPipeline::defaultPipeline()
@@ -237,7 +238,12 @@ GraphicsPipeline::~GraphicsPipeline() {}
 void GraphicsPipeline::bind(renderer::OperationContext& context)
 {
     auto& specContext = get(context);
-    specContext.commandBuffer->bindPipeline(pipeline(specContext), VK_PIPELINE_BIND_POINT_GRAPHICS);
+    {
+        //  pipelines are created on first use for a render pass
+        const auto lock = context.lockBindings();
+        specContext.commandBuffer->bindPipeline(pipeline(specContext),
+            VK_PIPELINE_BIND_POINT_GRAPHICS);
+    }
     specContext.graphicsPipeline = this;
 }
 
@@ -25,6 +25,7 @@ Buffer::Buffer(const Device& device, BufferCreateInfo bufferInfo, VkHandleType*
     , m_size(bufferInfo.size())
 {
     ASSERT(create(vkCreateBuffer, device, &bufferInfo, nullptr) == VK_SUCCESS);
+    device.countObject(ObjectCounter::BUFFER, 1);
 }
 
 Buffer::Buffer(const Device& device, BufferCreateInfo bufferInfo) noexcept
@@ -33,7 +34,8 @@ Buffer::Buffer(const Device& device, BufferCreateInfo bufferInfo) noexcept
 
 Buffer::~Buffer()
 {
-    destroy(vkDestroyBuffer, m_device, handle(), nullptr);
+    if (owner()) m_device.countObject(ObjectCounter::BUFFER, -1);
+    retire(m_device, vkDestroyBuffer, m_device.handle(), handle(), nullptr);
 }
 
 bool Buffer::bindMemory(uint32_t bindingOffset)
@@ -54,16 +56,28 @@ void Buffer::copyToImage(
         { &copyRegion, 1 });
 }
 
+std::weak_ptr<Memory> Buffer::allocateAndBindPreferredMemory(
+    VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred)
+{
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, handle(), &memRequirements);
+
+    m_memory = m_device.allocator().allocate(memRequirements,
+        m_device.allocator().findMemoryType(memRequirements, required, preferred),
+        vk::Allocator::LINEAR);
+    ASSERT(bindMemory(0));
+
+    return m_memory;
+}
+
 std::weak_ptr<Memory> Buffer::allocateMemoryImpl(VkMemoryPropertyFlags properties)
 {
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(m_device, handle(), &memRequirements);
 
-    m_memory = std::make_shared<Memory>(m_device,
-        MemoryAllocateInfo{}
-            .allocationSize(memRequirements.size)
-            .memoryTypeIndex(findMemoryType(m_device.physicalDevice(),
-                memRequirements.memoryTypeBits, properties)));
+    m_memory = m_device.allocator().allocate(memRequirements,
+        findMemoryType(m_device.physicalDevice(), memRequirements.memoryTypeBits, properties),
+        vk::Allocator::LINEAR);
 
     return m_memory;
 }
@@ -42,6 +42,10 @@ public:
         return allocateMemoryImpl(properties);
     }
 
+    //  see Allocator::findMemoryType for the way the preferred properties are taken into account
+    std::weak_ptr<Memory> allocateAndBindPreferredMemory(
+        VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred);
+
     void copyTo(const Buffer& dst, VkBufferCopy copyRegion) const;
     void copyToImage(const Image& dst, VkImageLayout dstLayout, VkBufferImageCopy copyRegion) const;
 
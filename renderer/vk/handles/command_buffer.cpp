@@ -2,9 +2,13 @@
 
 #include "command_pool.hpp"
 #include "descriptor_set.hpp"
+#include "device.hpp"
 #include "graphics_pipeline.hpp"
 #include "pipeline_layout.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace renderer::vk { namespace handles {
 
 CommandBuffer::CommandBuffer(const Device& device,
@@ -39,16 +43,21 @@ CommandBuffer::~CommandBuffer()
 
 VkResult CommandBuffer::begin(CommandBufferBeginInfo beginInfo) const
 {
+    forgetState();
     return vkBeginCommandBuffer(handle(), &beginInfo);
 }
 
 VkResult CommandBuffer::end() const
 {
+    m_device.countCommands(m_statistics);
+    m_statistics = CommandStatistics{};
+
     return vkEndCommandBuffer(handle());
 }
 
 VkResult CommandBuffer::reset(VkCommandBufferResetFlags flags) const
 {
+    forgetState();
     return vkResetCommandBuffer(handle(), flags);
 }
 
@@ -74,43 +83,121 @@ void CommandBuffer::drawIndexed(uint32_t indexCount,
     vkCmdDrawIndexed(handle(), indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 }
 
+void CommandBuffer::drawIndexedIndirect(
+    VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride) const
+{
+    vkCmdDrawIndexedIndirect(handle(), buffer, offset, drawCount, stride);
+}
+
+void CommandBuffer::drawIndexedIndirectCount(VkBuffer buffer,
+    VkDeviceSize offset,
+    VkBuffer countBuffer,
+    VkDeviceSize countBufferOffset,
+    uint32_t maxDrawCount,
+    uint32_t stride) const
+{
+    vkCmdDrawIndexedIndirectCount(
+        handle(), buffer, offset, countBuffer, countBufferOffset, maxDrawCount, stride);
+}
+
 void CommandBuffer::bindVertexBuffer(uint32_t firstBinding,
     uint32_t bindingCount,
     const VkBuffer* pBuffers,
     const VkDeviceSize* pOffsets) const
 {
+    auto& bound = m_bound.vertexBuffers;
+    if (bound.size() < firstBinding + bindingCount) bound.resize(firstBinding + bindingCount);
+
+    bool changed = false;
+    for (uint32_t i = 0; i < bindingCount; ++i)
+    {
+        auto& vertexBuffer = bound[firstBinding + i];
+        changed |= vertexBuffer.buffer != pBuffers[i] || vertexBuffer.offset != pOffsets[i];
+        vertexBuffer = { pBuffers[i], pOffsets[i] };
+    }
+    if (!filter(changed)) return;
+
     vkCmdBindVertexBuffers(handle(), firstBinding, bindingCount, pBuffers, pOffsets);
 }
 
 void CommandBuffer::bindIndexBuffer(
     VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType) const
 {
+    const bool changed = m_bound.indexBuffer != buffer || m_bound.indexOffset != offset ||
+        m_bound.indexType != indexType;
+    if (!filter(changed)) return;
+
+    m_bound.indexBuffer = buffer;
+    m_bound.indexOffset = offset;
+    m_bound.indexType = indexType;
     vkCmdBindIndexBuffer(handle(), buffer, offset, indexType);
 }
 
 void CommandBuffer::bindPipeline(const Pipeline& pipeline, VkPipelineBindPoint bindPoint) const
 {
+    DASSERT(static_cast<size_t>(bindPoint) < m_bound.bindPoints.size(),
+        "bind point is not tracked");
+
+    auto& bound = m_bound.bindPoints[bindPoint].pipeline;
+    if (!filter(bound != pipeline.handle())) return;
+
+    bound = pipeline.handle();
     vkCmdBindPipeline(handle(), bindPoint, pipeline);
 }
 
 void CommandBuffer::bindDescriptorSet(const PipelineLayout& layout,
     uint32_t firstSet,
-    std::shared_ptr<DescriptorSet> set,
+    const std::shared_ptr<DescriptorSet>& set,
     std::span<const uint32_t> dynamicOffsets,
     VkPipelineBindPoint bindPoint) const
 {
-    m_resourcesInUse.sets.push_back(set);
+    DASSERT(static_cast<size_t>(bindPoint) < m_bound.bindPoints.size(),
+        "bind point is not tracked");
+
+    auto& sets = m_bound.bindPoints[bindPoint].sets;
+    if (sets.size() <= firstSet) sets.resize(firstSet + 1);
+
+    auto& bound = sets[firstSet];
+    const bool changed = bound.layout != layout.handle() || bound.set != set->handle() ||
+        !std::equal(bound.dynamicOffsets.begin(), bound.dynamicOffsets.end(),
+            dynamicOffsets.begin(), dynamicOffsets.end());
+    if (!filter(changed)) return;
+
+    //  sets bound with an incompatible layout are disturbed, forgetting all of them is simpler
+    //  than checking compatibility
+    for (auto& other : sets)
+    {
+        if (other.layout != layout.handle()) other = BoundState::DescriptorSet{};
+    }
+    bound.layout = layout.handle();
+    bound.set = set->handle();
+    bound.dynamicOffsets.assign(dynamicOffsets.begin(), dynamicOffsets.end());
 
     vkCmdBindDescriptorSets(handle(), bindPoint, layout, firstSet, 1, set->handlePtr(),
         dynamicOffsets.size(), dynamicOffsets.data());
 }
 
+void CommandBuffer::pushConstants(const PipelineLayout& layout,
+    VkShaderStageFlags stageFlags,
+    uint32_t offset,
+    uint32_t size,
+    const void* values) const
+{
+    vkCmdPushConstants(handle(), layout, stageFlags, offset, size, values);
+}
+
 void CommandBuffer::copyBuffer(
     VkBuffer src, VkBuffer dst, std::span<const VkBufferCopy> regions) const
 {
     vkCmdCopyBuffer(handle(), src, dst, static_cast<uint32_t>(regions.size()), regions.data());
 }
 
+void CommandBuffer::fillBuffer(
+    VkBuffer dst, VkDeviceSize offset, VkDeviceSize size, uint32_t data) const
+{
+    vkCmdFillBuffer(handle(), dst, offset, size, data);
+}
+
 void CommandBuffer::copyBufferToImage(VkBuffer src,
     VkImage dst,
     VkImageLayout dstLayout,
@@ -147,7 +234,21 @@ void CommandBuffer::blitImage(VkImage srcImage,
 void CommandBuffer::setViewports(
     uint32_t firstViewport, uint32_t viewportCount, const VkViewport* pViewports) const
 {
-    vkCmdSetViewport(handle(), 0, 1, pViewports);
+    if (firstViewport == 0 && viewportCount == 1)
+    {
+        const bool changed = !m_bound.viewport ||
+            std::memcmp(&*m_bound.viewport, pViewports, sizeof(VkViewport)) != 0;
+        if (!filter(changed)) return;
+
+        m_bound.viewport = *pViewports;
+    }
+    else
+    {
+        filter(true);
+        if (firstViewport == 0) m_bound.viewport.reset();
+    }
+
+    vkCmdSetViewport(handle(), firstViewport, viewportCount, pViewports);
 }
 
 void CommandBuffer::setViewport(VkViewport viewport) const
@@ -158,7 +259,21 @@ void CommandBuffer::setViewport(VkViewport viewport) const
 void CommandBuffer::setScissors(
     uint32_t firstScissor, uint32_t scissorCount, const VkRect2D* pScissors) const
 {
-    vkCmdSetScissor(handle(), 0, 1, pScissors);
+    if (firstScissor == 0 && scissorCount == 1)
+    {
+        const bool changed = !m_bound.scissor ||
+            std::memcmp(&*m_bound.scissor, pScissors, sizeof(VkRect2D)) != 0;
+        if (!filter(changed)) return;
+
+        m_bound.scissor = *pScissors;
+    }
+    else
+    {
+        filter(true);
+        if (firstScissor == 0) m_bound.scissor.reset();
+    }
+
+    vkCmdSetScissor(handle(), firstScissor, scissorCount, pScissors);
 }
 
 void CommandBuffer::setScissor(VkRect2D scissor) const
@@ -171,9 +286,21 @@ void CommandBuffer::dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_
     vkCmdDispatch(handle(), groupCountX, groupCountY, groupCountZ);
 }
 
-CommandBuffer::Resources& CommandBuffer::resourcesInUse() const
+void CommandBuffer::executeCommands(std::span<const VkCommandBuffer> commandBuffers) const
+{
+    vkCmdExecuteCommands(handle(), commandBuffers.size(), commandBuffers.data());
+    forgetState();
+}
+
+bool CommandBuffer::filter(bool changed) const
+{
+    ++(changed ? m_statistics.issued : m_statistics.skipped);
+    return changed;
+}
+
+void CommandBuffer::forgetState() const
 {
-    return m_resourcesInUse;
+    m_bound = BoundState{};
 }
 
 
@@ -4,9 +4,14 @@
 
 #include "../utils.hpp"
 
+#include <types.hpp>
+
 #include <vulkan/vulkan.h>
 
+#include <array>
+#include <optional>
 #include <span>
+#include <vector>
 
 namespace renderer::vk { namespace handles {
 
@@ -18,6 +23,17 @@ BEGIN_DECLARE_VKSTRUCT(CommandBufferAllocateInfo, VK_STRUCTURE_TYPE_COMMAND_BUFF
     VKSTRUCT_PROPERTY(uint32_t, commandBufferCount)
 END_DECLARE_VKSTRUCT()
 
+BEGIN_DECLARE_VKSTRUCT(CommandBufferInheritanceInfo,
+    VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO)
+    VKSTRUCT_PROPERTY(const void*, pNext)
+    VKSTRUCT_PROPERTY(VkRenderPass, renderPass)
+    VKSTRUCT_PROPERTY(uint32_t, subpass)
+    VKSTRUCT_PROPERTY(VkFramebuffer, framebuffer)
+    VKSTRUCT_PROPERTY(VkBool32, occlusionQueryEnable)
+    VKSTRUCT_PROPERTY(VkQueryControlFlags, queryFlags)
+    VKSTRUCT_PROPERTY(VkQueryPipelineStatisticFlags, pipelineStatistics)
+END_DECLARE_VKSTRUCT()
+
 BEGIN_DECLARE_VKSTRUCT(CommandBufferBeginInfo, VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO)
     VKSTRUCT_PROPERTY(const void*, pNext)
     VKSTRUCT_PROPERTY(VkCommandBufferUsageFlags, flags)
@@ -30,16 +46,14 @@ class DescriptorSet;
 class Pipeline;
 class PipelineLayout;
 
+//  Remembers the state bound by the recorded commands and skips binds and dynamic state that
+//  wouldn't change it. The state is forgotten when recording begins and after secondary buffers
+//  are executed, it is undefined then. The counts of issued and skipped commands go to the device
+//  when recording ends
 class CommandBuffer : public Handle<VkCommandBuffer>
 {
     HANDLE(CommandBuffer);
 
-public:
-    struct Resources
-    {
-        std::vector<std::shared_ptr<DescriptorSet>> sets;
-    };
-
 public:
     CommandBuffer(const CommandBuffer& other) = delete;
     CommandBuffer(CommandBuffer&& other) noexcept;
@@ -63,6 +77,14 @@ public:
         uint32_t firstIndex,
         uint32_t vertexOffset,
         uint32_t firstInstance) const;
+    void drawIndexedIndirect(
+        VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride) const;
+    void drawIndexedIndirectCount(VkBuffer buffer,
+        VkDeviceSize offset,
+        VkBuffer countBuffer,
+        VkDeviceSize countBufferOffset,
+        uint32_t maxDrawCount,
+        uint32_t stride) const;
     void bindVertexBuffer(uint32_t firstBinding,
         uint32_t bindingCount,
         const VkBuffer* pBuffers,
@@ -72,11 +94,17 @@ public:
         VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
     void bindDescriptorSet(const PipelineLayout& layout,
         uint32_t firstSet,
-        std::shared_ptr<DescriptorSet> set,
+        const std::shared_ptr<DescriptorSet>& set,
         std::span<const uint32_t> dynamicOffsets,
         VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS) const;
+    void pushConstants(const PipelineLayout& layout,
+        VkShaderStageFlags stageFlags,
+        uint32_t offset,
+        uint32_t size,
+        const void* values) const;
 
     void copyBuffer(VkBuffer src, VkBuffer dst, std::span<const VkBufferCopy> regions) const;
+    void fillBuffer(VkBuffer dst, VkDeviceSize offset, VkDeviceSize size, uint32_t data) const;
     void copyBufferToImage(VkBuffer src,
         VkImage dst,
         VkImageLayout dstLayout,
@@ -103,7 +131,7 @@ public:
 
     void dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) const;
 
-    Resources& resourcesInUse() const;
+    void executeCommands(std::span<const VkCommandBuffer> commandBuffers) const;
 
 protected:
     CommandBuffer(const Device& device,
@@ -111,11 +139,53 @@ protected:
         VkCommandBufferLevel level,
         VkHandleType* handlePtr) noexcept;
 
+private:
+    struct BoundState
+    {
+        struct DescriptorSet
+        {
+            VkPipelineLayout layout = VK_NULL_HANDLE;
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            std::vector<uint32_t> dynamicOffsets;
+        };
+
+        struct BindPoint
+        {
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            //  indexed by set number
+            std::vector<DescriptorSet> sets;
+        };
+
+        struct VertexBuffer
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceSize offset = 0;
+        };
+
+        //  indexed by VK_PIPELINE_BIND_POINT_GRAPHICS and VK_PIPELINE_BIND_POINT_COMPUTE
+        std::array<BindPoint, 2> bindPoints;
+        //  indexed by binding
+        std::vector<VertexBuffer> vertexBuffers;
+
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        VkDeviceSize indexOffset = 0;
+        VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
+
+        //  of the first viewport and scissor only, the others are never filtered
+        std::optional<VkViewport> viewport;
+        std::optional<VkRect2D> scissor;
+    };
+
+    //  counts the command and returns whether it has to be recorded
+    bool filter(bool changed) const;
+    void forgetState() const;
+
 private:
     const Device& m_device;
     const CommandPool& m_pool;
 
-    mutable Resources m_resourcesInUse;
+    mutable BoundState m_bound;
+    mutable CommandStatistics m_statistics;
 };
 
 }}    //  namespace renderer::vk::handles
@@ -11,6 +11,7 @@ DescriptorPool::DescriptorPool(DescriptorPool&& other) noexcept
     , m_device(other.m_device)
     , m_maxSetCount(other.m_maxSetCount)
     , m_currentSetCount(other.m_currentSetCount)
+    , m_availableCallback(std::move(other.m_availableCallback))
 {}
 
 DescriptorPool::DescriptorPool(
@@ -22,6 +23,7 @@ DescriptorPool::DescriptorPool(
 {
     ASSERT(create(vkCreateDescriptorPool, m_device, &createInfo, nullptr) == VK_SUCCESS,
         "failed to create descriptor pool");
+    m_device.countObject(ObjectCounter::DESCRIPTOR_POOL, 1);
 }
 
 DescriptorPool::DescriptorPool(const Device& device, DescriptorPoolCreateInfo createInfo) noexcept
@@ -30,17 +32,14 @@ DescriptorPool::DescriptorPool(const Device& device, DescriptorPoolCreateInfo cr
 
 DescriptorPool::~DescriptorPool()
 {
-    destroy(vkDestroyDescriptorPool, m_device, handle(), nullptr);
+    if (owner()) m_device.countObject(ObjectCounter::DESCRIPTOR_POOL, -1);
+    retire(m_device, vkDestroyDescriptorPool, m_device.handle(), handle(), nullptr);
 }
 
 std::shared_ptr<DescriptorSet> DescriptorPool::allocateSet(const DescriptorSetLayout& layout)
 {
     auto set = std::shared_ptr<DescriptorSet>(new DescriptorSet(m_device, this, layout),
-        [this](DescriptorSet* set) {
-            if (set->m_pool.isAlive()) --m_currentSetCount;
-
-            std::default_delete<DescriptorSet>{}(set);
-        });
+        [&device = m_device](DescriptorSet* set) { retireSet(device, set); });
     ++m_currentSetCount;
 
     return set;
@@ -48,13 +47,44 @@ std::shared_ptr<DescriptorSet> DescriptorPool::allocateSet(const DescriptorSetLa
 
 std::vector<std::shared_ptr<DescriptorSet>> DescriptorPool::allocateSets(
     const HandleVector<DescriptorSetLayout>& layouts)
+{
+    return allocateSets(std::span{ layouts.handleData(), layouts.size() });
+}
+
+std::vector<std::shared_ptr<DescriptorSet>> DescriptorPool::allocateSets(
+    std::span<const VkDescriptorSetLayout> layouts)
 {
     m_currentSetCount += layouts.size();
-    return DescriptorSet::createShared(m_device, this, layouts, [this](DescriptorSet* set) {
-        if (set->m_pool.isAlive()) --m_currentSetCount;
+    return DescriptorSet::createShared(m_device, this, layouts,
+        [&device = m_device](DescriptorSet* set) { retireSet(device, set); });
+}
+
+std::shared_ptr<DescriptorSet> DescriptorPool::tryAllocateTransientSet(
+    const DescriptorSetLayout& layout)
+{
+    if (isFull()) return nullptr;
+
+    const auto allocateInfo = DescriptorSetAllocateInfo{}
+                                  .descriptorPool(handle())
+                                  .descriptorSetCount(1)
+                                  .pSetLayouts(layout.handlePtr());
+
+    VkDescriptorSet vkSet;
+    const VkResult result = vkAllocateDescriptorSets(m_device, &allocateInfo, &vkSet);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) return nullptr;
+
+    ASSERT(result == VK_SUCCESS, "failed to allocate descriptor sets!");
+    ++m_currentSetCount;
 
-        std::default_delete<DescriptorSet>{}(set);
-    });
+    //  not an owner, so the set isn't freed on destruction
+    return std::shared_ptr<DescriptorSet>(new DescriptorSet(m_device, this, vkSet));
+}
+
+void DescriptorPool::reset()
+{
+    ASSERT(vkResetDescriptorPool(m_device, handle(), 0) == VK_SUCCESS,
+        "failed to reset descriptor pool");
+    m_currentSetCount = 0;
 }
 
 bool DescriptorPool::isFull() const
@@ -67,5 +97,25 @@ bool DescriptorPool::isEmpty() const
     return !m_currentSetCount;
 }
 
+void DescriptorPool::retireSet(const Device& device, DescriptorSet* set)
+{
+    //  bound by submissions in flight until their fences signal, the pool may be gone by then
+    device.retire([set]() { freeSet(set); });
+}
+
+void DescriptorPool::freeSet(DescriptorSet* set)
+{
+    if (set->m_pool.isAlive())
+    {
+        auto& pool = *set->m_pool.ptr();
+        const bool wasFull = pool.isFull();
+        --pool.m_currentSetCount;
+
+        if (wasFull && pool.m_availableCallback) pool.m_availableCallback();
+    }
+
+    std::default_delete<DescriptorSet>{}(set);
+}
+
 
 }}    //  namespace renderer::vk::handles
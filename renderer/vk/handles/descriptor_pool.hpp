@@ -4,6 +4,7 @@
 #include "descriptor_set.hpp"
 
 #include <cstdint>
+#include <functional>
 #include <unordered_set>
 #include <span>
 #include <memory>
@@ -41,19 +42,40 @@ public:
     std::shared_ptr<DescriptorSet> allocateSet(const DescriptorSetLayout& layout);
     std::vector<std::shared_ptr<DescriptorSet>> allocateSets(
         const HandleVector<DescriptorSetLayout>& layouts);
+    //  all of the sets are allocated with a single call
+    std::vector<std::shared_ptr<DescriptorSet>> allocateSets(
+        std::span<const VkDescriptorSetLayout> layouts);
+
+    //  the set is never freed on its own, it is released by reset(), returns nullptr if the pool
+    //  is out of memory
+    std::shared_ptr<DescriptorSet> tryAllocateTransientSet(const DescriptorSetLayout& layout);
+    void reset();
+
+    //  called whenever a set of a full pool is freed
+    void setAvailableCallback(std::function<void()> callback)
+    {
+        m_availableCallback = std::move(callback);
+    }
 
     bool isFull() const;
     bool isEmpty() const;
+    uint32_t freeSetCount() const { return m_maxSetCount - m_currentSetCount; }
 
 protected:
     DescriptorPool(const Device& device,
         DescriptorPoolCreateInfo createInfo,
         VkHandleType* handlePtr) noexcept;
 
+private:
+    static void retireSet(const Device& device, DescriptorSet* set);
+    static void freeSet(DescriptorSet* set);
+
 private:
     const Device& m_device;
     const uint32_t m_maxSetCount;
     uint32_t m_currentSetCount;
+
+    std::function<void()> m_availableCallback;
 };
 
 }}    //  namespace renderer::vk::handles
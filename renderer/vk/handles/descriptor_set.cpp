@@ -3,6 +3,7 @@
 #include "device.hpp"
 #include "descriptor_pool.hpp"
 #include "descriptor_set_layout.hpp"
+#include "descriptor_update_template.hpp"
 
 namespace renderer::vk { namespace handles {
 
@@ -25,14 +26,14 @@ HandleVector<DescriptorSet> DescriptorSet::create(const Device& device,
 
 std::vector<std::shared_ptr<DescriptorSet>> DescriptorSet::createShared(const Device& device,
     HandlePtr<DescriptorPool> pool,
-    const HandleVector<DescriptorSetLayout>& setLayouts,
+    std::span<const VkDescriptorSetLayout> setLayouts,
     std::function<void(DescriptorSet*)> destructor)
 {
     const auto allocateInfo =
         DescriptorSetAllocateInfo{}
             .descriptorPool(pool->handle())
             .descriptorSetCount(setLayouts.size())
-            .pSetLayouts(setLayouts.handleData());
+            .pSetLayouts(setLayouts.data());
 
     std::vector<VkDescriptorSet> allocatedSets;
     allocatedSets.resize(allocateInfo.descriptorSetCount());
@@ -112,4 +113,9 @@ void DescriptorSet::write(std::span<const WriteDescriptorSet> writes)
         nullptr);
 }
 
+void DescriptorSet::write(const DescriptorUpdateTemplate& updateTemplate, const void* data)
+{
+    vkUpdateDescriptorSetWithTemplate(m_device, handle(), updateTemplate, data);
+}
+
 }}    //  namespace renderer::vk::handles
@@ -33,6 +33,7 @@ END_DECLARE_VKSTRUCT()
 class Device;
 class DescriptorPool;
 class DescriptorSetLayout;
+class DescriptorUpdateTemplate;
 
 class DescriptorSet : public Handle<VkDescriptorSet>
 {
@@ -54,6 +55,8 @@ public:
 
     void write(std::span<const Write> writes);
     void write(std::span<const WriteDescriptorSet> writes);
+    //  data is laid out as the template entries describe it
+    void write(const DescriptorUpdateTemplate& updateTemplate, const void* data);
 
 protected:
     static HandleVector<DescriptorSet> create(const Device& device,
@@ -62,7 +65,7 @@ protected:
 
     static std::vector<std::shared_ptr<DescriptorSet>> createShared(const Device& device,
         HandlePtr<DescriptorPool> pool,
-        const HandleVector<DescriptorSetLayout>& setLayouts,
+        std::span<const VkDescriptorSetLayout> setLayouts,
         std::function<void(DescriptorSet*)> destructor = std::default_delete<DescriptorSet>{});
 
 protected:
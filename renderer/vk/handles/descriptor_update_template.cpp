@@ -0,0 +1,33 @@
+#include "descriptor_update_template.hpp"
+
+#include "device.hpp"
+
+namespace renderer::vk { namespace handles {
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept
+    : Handle(std::move(other))
+    , m_device(other.m_device)
+{}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(const Device& device,
+    DescriptorUpdateTemplateCreateInfo createInfo,
+    VkHandleType* handlePtr) noexcept
+    : Handle(handlePtr)
+    , m_device(device)
+{
+    ASSERT(create(vkCreateDescriptorUpdateTemplate, m_device, &createInfo, nullptr) ==
+            VK_SUCCESS,
+        "failed to create descriptor update template");
+}
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(
+    const Device& device, DescriptorUpdateTemplateCreateInfo createInfo) noexcept
+    : DescriptorUpdateTemplate(device, std::move(createInfo), nullptr)
+{}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate()
+{
+    destroy(vkDestroyDescriptorUpdateTemplate, m_device, handle(), nullptr);
+}
+
+}}    //  namespace renderer::vk::handles
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "handle.hpp"
+
+#include "vk/utils.hpp"
+
+namespace renderer::vk { namespace handles {
+
+BEGIN_DECLARE_VKSTRUCT(DescriptorUpdateTemplateCreateInfo,
+    VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO)
+    VKSTRUCT_PROPERTY(const void*, pNext)
+    VKSTRUCT_PROPERTY(VkDescriptorUpdateTemplateCreateFlags, flags)
+    VKSTRUCT_PROPERTY(uint32_t, descriptorUpdateEntryCount)
+    VKSTRUCT_PROPERTY(const VkDescriptorUpdateTemplateEntry*, pDescriptorUpdateEntries)
+    VKSTRUCT_PROPERTY(VkDescriptorUpdateTemplateType, templateType)
+    VKSTRUCT_PROPERTY(VkDescriptorSetLayout, descriptorSetLayout)
+    VKSTRUCT_PROPERTY(VkPipelineBindPoint, pipelineBindPoint)
+    VKSTRUCT_PROPERTY(VkPipelineLayout, pipelineLayout)
+    VKSTRUCT_PROPERTY(uint32_t, set)
+END_DECLARE_VKSTRUCT()
+
+//  packed element of the data a template is applied to, one per template entry
+union DescriptorUpdateInfo
+{
+    VkDescriptorBufferInfo bufferInfo;
+    VkDescriptorImageInfo imageInfo;
+};
+
+class Device;
+
+class DescriptorUpdateTemplate : public Handle<VkDescriptorUpdateTemplate>
+{
+    HANDLE(DescriptorUpdateTemplate);
+
+public:
+    DescriptorUpdateTemplate(const DescriptorUpdateTemplate& other) = delete;
+    DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept;
+    DescriptorUpdateTemplate(
+        const Device& device, DescriptorUpdateTemplateCreateInfo createInfo) noexcept;
+    virtual ~DescriptorUpdateTemplate();
+
+protected:
+    DescriptorUpdateTemplate(const Device& device,
+        DescriptorUpdateTemplateCreateInfo createInfo,
+        VkHandleType* handlePtr) noexcept;
+
+private:
+    const Device& m_device;
+};
+
+}}    //  namespace renderer::vk::handles
@@ -1,12 +1,23 @@
 #include "device.hpp"
 
 #include "command_pool.hpp"
+#include "memory.hpp"
 #include "queue.hpp"
 
+#include "vk/allocator.hpp"
+#include "vk/staging_ring.hpp"
+#include "vk/upload_manager.hpp"
+#include "vk/readback_ring.hpp"
+#include "vk/bindless_texture_table.hpp"
+#include "vk/uniform_arena.hpp"
+#include "vk/secondary_recorder.hpp"
+#include "vk/deletion_queue.hpp"
+#include "vk/ifenced_resource.hpp"
 #include "vk/graphics_context.hpp"
 #include "vk/types.hpp"
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 #include <functional>
 #include <stdexcept>
@@ -70,6 +81,13 @@ QueueFamilies::QueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface)
             m_queueFamilyIndices[QueueFamilyType::GRAPHICS_COMPUTE] = i;
         }
 
+        if ((queueFamilyProperties[i].queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+            !(queueFamilyProperties[i].queueFlags &
+                (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+        {
+            m_queueFamilyIndices[QueueFamilyType::TRANSFER] = i;
+        }
+
         VkBool32 presentSupport = false;
         vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
         if (presentSupport)
@@ -77,6 +95,13 @@ QueueFamilies::QueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface)
             m_queueFamilyIndices[QueueFamilyType::PRESENT] = i;
         }
     }
+
+    //  graphics and compute queues support transfer operations implicitly
+    if (m_queueFamilyIndices[QueueFamilyType::TRANSFER] == invalidIndex)
+    {
+        m_queueFamilyIndices[QueueFamilyType::TRANSFER] =
+            m_queueFamilyIndices[QueueFamilyType::GRAPHICS_COMPUTE];
+    }
 }
 
 bool QueueFamilies::isComplete() const
@@ -114,6 +139,24 @@ Device::Device(VkInstance instance, VkSurfaceKHR surface, VkHandleType* handlePt
 {
     pickPhysicalDevice();
     createLogicalDevice();
+
+    m_allocator = std::make_unique<vk::Allocator>(*this);
+    m_deletionQueue = std::make_unique<vk::DeletionQueue>(*this);
+    m_stagingRing = std::make_unique<vk::StagingRing>(*this);
+    m_uploadManager = std::make_unique<vk::UploadManager>(*this);
+    m_readbackRing = std::make_unique<vk::ReadbackRing>(*this);
+    m_uniformArena = std::make_unique<vk::UniformArena>(*this);
+    m_secondaryRecorder = std::make_unique<vk::SecondaryRecorder>(*this);
+    if (m_descriptorIndexingSupported)
+    {
+        m_bindlessTextureTable = std::make_unique<vk::BindlessTextureTable>(*this);
+    }
+
+    m_fencedResources = { m_stagingRing.get(), m_readbackRing.get(), m_uniformArena.get(),
+        m_secondaryRecorder.get() };
+    if (m_bindlessTextureTable) m_fencedResources.push_back(m_bindlessTextureTable.get());
+    //  destructions run once everything else the fence held has been taken back
+    m_fencedResources.push_back(m_deletionQueue.get());
 }
 
 Device::Device(VkInstance instance, VkSurfaceKHR surface) noexcept
@@ -122,7 +165,19 @@ Device::Device(VkInstance instance, VkSurfaceKHR surface) noexcept
 
 Device::~Device()
 {
+    //  the subsystems destroy pools, fences and command buffers right away
+    if (owner()) waitIdle();
+
+    m_fencedResources.clear();
+    m_bindlessTextureTable.reset();
+    m_secondaryRecorder.reset();
+    m_uniformArena.reset();
+    m_readbackRing.reset();
+    m_uploadManager.reset();
+    m_stagingRing.reset();
+    m_deletionQueue.reset();
     m_commandPools.clear();
+    m_allocator.reset();
     destroy(vkDestroyDevice, handle(), nullptr);
 }
 
@@ -131,6 +186,36 @@ void Device::waitIdle() const
     vkDeviceWaitIdle(handle());
 }
 
+void Device::recordFence(VkFence fence, vk::IFencedResource& target, bool renderPass) const
+{
+    target.record(fence);
+    for (auto* resource : m_fencedResources)
+    {
+        if (renderPass || !resource->renderPassOnly()) resource->record(fence);
+    }
+}
+
+void Device::releaseFence(VkFence fence, vk::IFencedResource& target) const
+{
+    target.release(fence);
+    for (auto* resource : m_fencedResources)
+    {
+        resource->release(fence);
+    }
+}
+
+void Device::retire(std::function<void()> destroy) const
+{
+    //  the queue is gone while the device is destroyed, the device is idle by then
+    if (!m_deletionQueue)
+    {
+        destroy();
+        return;
+    }
+
+    m_deletionQueue->retire(std::move(destroy));
+}
+
 VkMemoryType Device::memoryType(uint32_t index) const
 {
     DASSERT(index < m_physicalDeviceMemoryProperties.memoryTypeCount, "wrong memory type index");
@@ -138,6 +223,61 @@ VkMemoryType Device::memoryType(uint32_t index) const
     return m_physicalDeviceMemoryProperties.memoryTypes[index];
 }
 
+VkMemoryHeap Device::memoryHeap(uint32_t index) const
+{
+    DASSERT(index < m_physicalDeviceMemoryProperties.memoryHeapCount, "wrong memory heap index");
+
+    return m_physicalDeviceMemoryProperties.memoryHeaps[index];
+}
+
+uint32_t Device::memoryTypeCount() const
+{
+    return m_physicalDeviceMemoryProperties.memoryTypeCount;
+}
+
+uint32_t Device::memoryHeapCount() const
+{
+    return m_physicalDeviceMemoryProperties.memoryHeapCount;
+}
+
+std::optional<VkPhysicalDeviceMemoryBudgetPropertiesEXT> Device::memoryBudget() const
+{
+    if (!m_memoryBudgetSupported) return std::nullopt;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+    budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    VkPhysicalDeviceMemoryProperties2 properties{};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    properties.pNext = &budget;
+    vkGetPhysicalDeviceMemoryProperties2(m_physicalDevice, &properties);
+
+    return budget;
+}
+
+void Device::countObject(ObjectCounter counter, int64_t delta) const
+{
+    m_objectCounts[static_cast<size_t>(counter)] += delta;
+}
+
+uint64_t Device::objectCount(ObjectCounter counter) const
+{
+    return m_objectCounts[static_cast<size_t>(counter)];
+}
+
+void Device::countCommands(const CommandStatistics& statistics) const
+{
+    m_issuedCommands.fetch_add(statistics.issued, std::memory_order_relaxed);
+    m_skippedCommands.fetch_add(statistics.skipped, std::memory_order_relaxed);
+}
+
+CommandStatistics Device::commandStatistics() const
+{
+    return CommandStatistics{
+        .issued = m_issuedCommands.load(std::memory_order_relaxed),
+        .skipped = m_skippedCommands.load(std::memory_order_relaxed),
+    };
+}
+
 void Device::pickPhysicalDevice()
 {
     uint32_t physicalDeviceCount = 0;
@@ -179,22 +319,63 @@ void Device::createLogicalDevice()
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
+    m_multiDrawIndirectSupported = m_physicalDeviceFeatures.multiDrawIndirect;
+    deviceFeatures.multiDrawIndirect = m_multiDrawIndirectSupported;
+    m_drawIndirectFirstInstanceSupported = m_physicalDeviceFeatures.drawIndirectFirstInstance;
+    deviceFeatures.drawIndirectFirstInstance = m_drawIndirectFirstInstanceSupported;
+
+    VkPhysicalDeviceVulkan12Features supportedVulkan12Features{};
+    supportedVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 supportedFeatures{};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext = &supportedVulkan12Features;
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supportedFeatures);
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+
+    //  everything the bindless texture table relies on, it is left out if any is missing
+    m_descriptorIndexingSupported = supportedVulkan12Features.runtimeDescriptorArray &&
+        supportedVulkan12Features.descriptorBindingPartiallyBound &&
+        supportedVulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+        supportedVulkan12Features.descriptorBindingUpdateUnusedWhilePending &&
+        supportedVulkan12Features.shaderSampledImageArrayNonUniformIndexing;
+    if (m_descriptorIndexingSupported)
+    {
+        vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+        vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    }
+
+    //  lets gpu culling pass the number of visible objects to the draw
+    m_drawIndirectCountSupported = supportedVulkan12Features.drawIndirectCount;
+    vulkan12Features.drawIndirectCount = m_drawIndirectCountSupported;
+
+    std::vector<const char*> extensions(s_deviceExtensions.begin(), s_deviceExtensions.end());
+    m_memoryBudgetSupported =
+        isExtensionSupported(m_physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (m_memoryBudgetSupported) extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 
     const auto createInfo = GraphicsContext::s_enableValidationLayers ?
         DeviceCreateInfo{}
+            .pNext(&vulkan12Features)
             .pEnabledFeatures(&deviceFeatures)
             .pQueueCreateInfos(queueCreateInfos.data())
             .queueCreateInfoCount(queueCreateInfos.size())
-            .enabledExtensionCount(s_deviceExtensions.size())
-            .ppEnabledExtensionNames(s_deviceExtensions.data())
+            .enabledExtensionCount(extensions.size())
+            .ppEnabledExtensionNames(extensions.data())
             .enabledLayerCount(GraphicsContext::s_validationLayers.size())
             .ppEnabledLayerNames(GraphicsContext::s_validationLayers.data()) :
         DeviceCreateInfo{}
+            .pNext(&vulkan12Features)
             .pEnabledFeatures(&deviceFeatures)
             .pQueueCreateInfos(queueCreateInfos.data())
             .queueCreateInfoCount(queueCreateInfos.size())
-            .enabledExtensionCount(s_deviceExtensions.size())
-            .ppEnabledExtensionNames(s_deviceExtensions.data());
+            .enabledExtensionCount(extensions.size())
+            .ppEnabledExtensionNames(extensions.data());
 
     ASSERT(create(vkCreateDevice, m_physicalDevice, &createInfo, nullptr) == VK_SUCCESS,
         "failed to create logical device!");
@@ -207,6 +388,18 @@ bool Device::isDeviceSuitable(VkPhysicalDevice device)
         return false;
     }
 
+    //  timeline semaphores back the completion tokens of the upload manager
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan12Features;
+    vkGetPhysicalDeviceFeatures2(device, &features);
+    if (!vulkan12Features.timelineSemaphore)
+    {
+        return false;
+    }
+
     const auto swapChainSupportDetails = Device::swapChainSupportDetails(device, m_surface);
     const bool swapChainAdequate =
         !swapChainSupportDetails.formats.empty() && !swapChainSupportDetails.presentModes.empty();
@@ -235,6 +428,47 @@ bool Device::checkDeviceExtensionSupport(VkPhysicalDevice device)
     return requiredExtensions.empty();
 }
 
+bool Device::isExtensionSupported(VkPhysicalDevice device, const char* extensionName)
+{
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount,
+        availableExtensions.data());
+
+    return std::any_of(availableExtensions.begin(), availableExtensions.end(),
+        [extensionName](const auto& extension) {
+            return std::strcmp(extension.extensionName, extensionName) == 0;
+        });
+}
+
+void Device::markDirty(const Memory& memory) const
+{
+    m_dirtyMemories.push_back(&memory);
+}
+
+void Device::forgetDirty(const Memory& memory) const
+{
+    std::erase(m_dirtyMemories, &memory);
+}
+
+void Device::flushMappedMemory() const
+{
+    if (m_dirtyMemories.empty()) return;
+
+    m_flushRanges.clear();
+    for (const Memory* memory : m_dirtyMemories)
+    {
+        memory->collectDirtyRanges(m_flushRanges);
+    }
+    m_dirtyMemories.clear();
+
+    ASSERT(vkFlushMappedMemoryRanges(handle(), m_flushRanges.size(), m_flushRanges.data()) ==
+            VK_SUCCESS,
+        "failed to flush mapped memory");
+}
+
 std::weak_ptr<Queue> Device::queue(QueueFamilyType type, uint32_t idx) const
 {
     const uint32_t familyIdx = m_queueFamilies.queueFamilyIndex(type);
@@ -3,7 +3,11 @@
 #include "command.hpp"
 #include "handle.hpp"
 
+#include <types.hpp>
+
 #include <array>
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <map>
 #include <memory>
@@ -13,7 +17,19 @@
 
 #include <vulkan/vulkan_core.h>
 
-namespace renderer::vk { namespace handles {
+namespace renderer::vk {
+
+class Allocator;
+class StagingRing;
+class UploadManager;
+class ReadbackRing;
+class BindlessTextureTable;
+class UniformArena;
+class SecondaryRecorder;
+class DeletionQueue;
+class IFencedResource;
+
+namespace handles {
 
 BEGIN_DECLARE_VKSTRUCT(DeviceCreateInfo, VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO)
     VKSTRUCT_PROPERTY(const void*, pNext)
@@ -29,11 +45,23 @@ END_DECLARE_VKSTRUCT()
 
 class Queue;
 class CommandPool;
+struct Memory;
+
+//  objects the device keeps live counts of for the memory statistics
+enum class ObjectCounter : uint8_t
+{
+    BUFFER,
+    IMAGE,
+    DESCRIPTOR_POOL,
+    COUNT
+};
 
 enum QueueFamilyType : uint16_t
 {
     GRAPHICS_COMPUTE,
     PRESENT,
+    //  dedicated transfer family if the device has one, GRAPHICS_COMPUTE otherwise
+    TRANSFER,
     COUNT
 };
 
@@ -89,6 +117,45 @@ public:
     QueueFamilies queueFamilies() const { return m_queueFamilies; };
 
     VkMemoryType memoryType(uint32_t index) const;
+    VkMemoryHeap memoryHeap(uint32_t index) const;
+    uint32_t memoryTypeCount() const;
+    uint32_t memoryHeapCount() const;
+
+    //  filled by VK_EXT_memory_budget, nothing if the device doesn't support it
+    std::optional<VkPhysicalDeviceMemoryBudgetPropertiesEXT> memoryBudget() const;
+
+    void countObject(ObjectCounter counter, int64_t delta) const;
+    uint64_t objectCount(ObjectCounter counter) const;
+
+    //  added by command buffers when they end recording, secondary ones end on worker threads
+    void countCommands(const CommandStatistics& statistics) const;
+    CommandStatistics commandStatistics() const;
+
+    vk::Allocator& allocator() const { return *m_allocator; }
+
+    vk::StagingRing& stagingRing() const { return *m_stagingRing; }
+
+    vk::UploadManager& uploadManager() const { return *m_uploadManager; }
+    vk::ReadbackRing& readbackRing() const { return *m_readbackRing; }
+    vk::UniformArena& uniformArena() const { return *m_uniformArena; }
+    vk::SecondaryRecorder& secondaryRecorder() const { return *m_secondaryRecorder; }
+    vk::DeletionQueue& deletionQueue() const { return *m_deletionQueue; }
+    //  null if the device doesn't support descriptor indexing
+    vk::BindlessTextureTable* bindlessTextureTable() const { return m_bindlessTextureTable.get(); }
+
+    //  hands the fence of a submission to every subsystem above and to the resources of the target
+    //  submitting it, compute submissions skip the ones used by render passes only
+    void recordFence(VkFence fence, vk::IFencedResource& target, bool renderPass) const;
+    //  the fence has been waited for, everything handed to it is taken back
+    void releaseFence(VkFence fence, vk::IFencedResource& target) const;
+
+    //  runs once the submissions in flight are done with the objects it destroys
+    void retire(std::function<void()> destroy) const;
+
+    //  non coherent memory is flushed once per submission instead of on every write
+    void markDirty(const Memory& memory) const;
+    void forgetDirty(const Memory& memory) const;
+    void flushMappedMemory() const;
 
     std::weak_ptr<Queue> queue(QueueFamilyType type, uint32_t idx = 0) const;
     std::weak_ptr<CommandPool> commandPool(QueueFamilyType type) const;
@@ -101,6 +168,16 @@ public:
         return m_physicalDeviceProperties;
     }
 
+    //  indirect draws take their count from a buffer, otherwise they draw every command
+    bool drawIndirectCountSupported() const { return m_drawIndirectCountSupported; }
+    //  indirect draws issue more than one command per call
+    bool multiDrawIndirectSupported() const { return m_multiDrawIndirectSupported; }
+    //  indirect commands may start past the first instance, firstInstance has to be 0 otherwise
+    bool drawIndirectFirstInstanceSupported() const
+    {
+        return m_drawIndirectFirstInstanceSupported;
+    }
+
 protected:
     Device(VkInstance instance, VkSurfaceKHR surface, VkHandleType* handlePtr) noexcept;
 
@@ -110,6 +187,7 @@ private:
 
     bool isDeviceSuitable(VkPhysicalDevice device);
     static bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+    static bool isExtensionSupported(VkPhysicalDevice device, const char* extensionName);
 
 private:
     const VkInstance m_instance;
@@ -118,6 +196,25 @@ private:
     QueueFamilies m_queueFamilies;
     mutable std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<Queue>> m_queues;
     mutable std::map<uint32_t, std::shared_ptr<CommandPool>> m_commandPools;
+    std::unique_ptr<vk::Allocator> m_allocator;
+    std::unique_ptr<vk::DeletionQueue> m_deletionQueue;
+    std::unique_ptr<vk::StagingRing> m_stagingRing;
+    std::unique_ptr<vk::UploadManager> m_uploadManager;
+    std::unique_ptr<vk::ReadbackRing> m_readbackRing;
+    std::unique_ptr<vk::BindlessTextureTable> m_bindlessTextureTable;
+    std::unique_ptr<vk::UniformArena> m_uniformArena;
+    std::unique_ptr<vk::SecondaryRecorder> m_secondaryRecorder;
+    std::vector<vk::IFencedResource*> m_fencedResources;
+    mutable std::vector<const Memory*> m_dirtyMemories;
+    mutable std::vector<VkMappedMemoryRange> m_flushRanges;
+    mutable std::array<uint64_t, static_cast<size_t>(ObjectCounter::COUNT)> m_objectCounts{};
+    mutable std::atomic<uint64_t> m_issuedCommands = 0;
+    mutable std::atomic<uint64_t> m_skippedCommands = 0;
+    bool m_memoryBudgetSupported = false;
+    bool m_descriptorIndexingSupported = false;
+    bool m_drawIndirectCountSupported = false;
+    bool m_multiDrawIndirectSupported = false;
+    bool m_drawIndirectFirstInstanceSupported = false;
 
     //  TO DO: Support for multiple devices
     VkPhysicalDevice m_physicalDevice;
@@ -126,4 +223,5 @@ private:
     VkPhysicalDeviceMemoryProperties m_physicalDeviceMemoryProperties;
 };
 
-}}    //  namespace renderer::vk::handles
+}    //  namespace handles
+}    //  namespace renderer::vk
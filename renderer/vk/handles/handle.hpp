@@ -155,6 +155,16 @@ protected:
         }
     }
 
+    //  destroys once the submissions in flight are done, the arguments are kept by value
+    void retire(const auto& device, auto destroyFunc, auto... args)
+    {
+        if (owner())
+        {
+            device.retire([=]() { destroyFunc(args...); });
+            setOwner(false);
+        }
+    }
+
 private:
     void addDeleteWatcher(Watcher* watcherPtr) { m_deleteWatchers.insert(watcherPtr); }
 
@@ -35,6 +35,7 @@ Image::Image(const Device& device, ImageCreateInfo imageInfo, VkHandleType* hand
 {
     ASSERT(create(vkCreateImage, device, &imageInfo, nullptr) == VK_SUCCESS,
         "failed to create image!");
+    device.countObject(ObjectCounter::IMAGE, 1);
 }
 
 Image::Image(const Device& device, ImageCreateInfo imageInfo) noexcept
@@ -43,7 +44,8 @@ Image::Image(const Device& device, ImageCreateInfo imageInfo) noexcept
 
 Image::~Image()
 {
-    destroy(vkDestroyImage, m_device, handle(), nullptr);
+    if (owner()) m_device.countObject(ObjectCounter::IMAGE, -1);
+    retire(m_device, vkDestroyImage, m_device.handle(), handle(), nullptr);
 }
 
 bool Image::bindMemory(uint32_t bindingOffset)
@@ -56,7 +58,14 @@ void Image::transitionLayout(
     VkImageLayout oldLayout, VkImageLayout newLayout, ImageSubresourceRange subresourceRange)
 {
     auto oneTimeCommand = m_device.oneTimeCommand(GRAPHICS_COMPUTE);
+    transitionLayout(oneTimeCommand(), oldLayout, newLayout, subresourceRange);
+}
 
+void Image::transitionLayout(const CommandBuffer& commandBuffer,
+    VkImageLayout oldLayout,
+    VkImageLayout newLayout,
+    ImageSubresourceRange subresourceRange) const
+{
     auto barrier =
         ImageMemoryBarrier{}
             .oldLayout(oldLayout)
@@ -91,7 +100,7 @@ void Image::transitionLayout(
         throw std::invalid_argument("unsupported layout transition!");
     }
 
-    oneTimeCommand().pipelineBarrier(sourceStage, destinationStage, 0,
+    commandBuffer.pipelineBarrier(sourceStage, destinationStage, 0,
         std::span<ImageMemoryBarrier, 1>(&barrier, 1));
 }
 
@@ -100,11 +109,29 @@ std::weak_ptr<Memory> Image::allocateMemoryImpl(VkMemoryPropertyFlags properties
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(m_device, handle(), &memRequirements);
 
-    m_memory = std::make_shared<Memory>(m_device,
-        MemoryAllocateInfo{}
-            .allocationSize(memRequirements.size)
-            .memoryTypeIndex(findMemoryType(m_device.physicalDevice(),
-                memRequirements.memoryTypeBits, properties)));
+    m_memory = m_device.allocator().allocate(memRequirements,
+        findMemoryType(m_device.physicalDevice(), memRequirements.memoryTypeBits, properties),
+        vk::Allocator::OPTIMAL);
+
+    return m_memory;
+}
+
+std::weak_ptr<Memory> Image::allocateAndBindTransientMemory()
+{
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(m_device, handle(), &memRequirements);
+
+    const auto lazyMemoryType = tryFindMemoryType(m_device.physicalDevice(),
+        memRequirements.memoryTypeBits,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+    if (!lazyMemoryType.has_value())
+    {
+        return allocateAndBindMemory(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    m_memory = m_device.allocator().allocate(memRequirements, lazyMemoryType.value(),
+        vk::Allocator::OPTIMAL);
+    ASSERT(bindMemory(0));
 
     return m_memory;
 }
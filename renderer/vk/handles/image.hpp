@@ -60,6 +60,7 @@ BEGIN_DECLARE_VKSTRUCT(ImageCreateInfo, VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO)
     VKSTRUCT_PROPERTY(VkImageLayout, initialLayout)
 END_DECLARE_VKSTRUCT()
 
+class CommandBuffer;
 class Swapchain;
 
 class Image
@@ -84,8 +85,16 @@ public:
         return allocateMemoryImpl(properties);
 	}
 
+    //  for attachments created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, prefers lazily
+    //  allocated memory which tile based gpus never back with physical pages
+    std::weak_ptr<Memory> allocateAndBindTransientMemory();
+
     void transitionLayout(
         VkImageLayout oldLayout, VkImageLayout newLayout, ImageSubresourceRange subresourceRange);
+    void transitionLayout(const CommandBuffer& commandBuffer,
+        VkImageLayout oldLayout,
+        VkImageLayout newLayout,
+        ImageSubresourceRange subresourceRange) const;
 
 protected:
     Image(const Device& device, VkHandleType* handlePtr) noexcept;
@@ -24,7 +24,7 @@ ImageView::ImageView(const Device& device, ImageViewCreateInfo createInfo) noexc
 
 ImageView::~ImageView()
 {
-    destroy(vkDestroyImageView, m_device, handle(), nullptr);
+    retire(m_device, vkDestroyImageView, m_device.handle(), handle(), nullptr);
 }
 
 }}    //  namespace renderer::vk::handles
@@ -3,10 +3,28 @@
 #include "buffer.hpp"
 #include "device.hpp"
 
+#include "../staging_ring.hpp"
+
+#include <algorithm>
 #include <cstring>
+#include <utility>
 
 namespace renderer::vk { namespace handles {
 
+//  non coherent ranges are flushed and invalidated by whole atoms, relative to the device memory
+static std::pair<VkDeviceSize, VkDeviceSize> atomAlignedRange(
+    const Memory& memory, VkDeviceSize size, ptrdiff_t offset)
+{
+    const auto atomSize = memory.device.physicalDeviceProperties().limits.nonCoherentAtomSize;
+
+    const VkDeviceSize begin = (memory.offset + offset) / atomSize * atomSize;
+    const VkDeviceSize end = (std::min)(
+        (memory.offset + offset + size + atomSize - 1) / atomSize * atomSize,
+        memory.offset + memory.size);
+
+    return { begin, end };
+}
+
 Memory::Mapped::Mapped(const Memory& memory)
     : memory(memory)
 {}
@@ -22,49 +40,88 @@ void Memory::Mapped::writeAndSync(const void* src, VkDeviceSize size, ptrdiff_t
 Memory::DeviceLocalMapped::DeviceLocalMapped(const Memory& memory, VkDeviceSize offset)
     : Mapped(memory)
     , offset(offset)
-{
-    stagingBuffer = std::make_unique<Buffer>(memory.device, Buffer::staging().size(memory.size));
-    stagingBuffer
-        ->allocateAndBindMemory(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-        .lock()
-        ->map();
-}
+{}
 
 Memory::DeviceLocalMapped::~DeviceLocalMapped() {}
 
+//  blocking path, frame to frame readbacks should go through the readback ring instead
 const void* Memory::DeviceLocalMapped::read(VkDeviceSize size, ptrdiff_t offset) const
 {
-    ASSERT(false, "not implemented");
-    return nullptr;
+    //  staged writes to the same range have to land before it is copied back
+    memory.device.stagingRing().flush();
+
+    Buffer readbackBuffer(memory.device,
+        BufferCreateInfo{}
+            .size(size)
+            .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+            .sharingMode(VK_SHARING_MODE_EXCLUSIVE));
+    auto mapped = readbackBuffer
+                      .allocateAndBindMemory(
+                          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+                      .lock()
+                      ->map()
+                      .lock();
+
+    memory.buffer().copyTo(readbackBuffer,
+        {
+            .srcOffset = this->offset + static_cast<VkDeviceSize>(offset),
+            .dstOffset = 0,
+            .size = size,
+        });
+
+    readCache.resize(size);
+    std::memcpy(readCache.data(), mapped->read(size), size);
+
+    return readCache.data();
 }
 
 void Memory::DeviceLocalMapped::write(const void* src, VkDeviceSize size, ptrdiff_t offset)
 {
-    stagingBuffer->memory().lock()->mapped->writeAndSync(src, size, offset);
-}
+    const VkDeviceSize dstOffset = this->offset + static_cast<VkDeviceSize>(offset);
+    if (memory.device.stagingRing().upload(src, size, memory.buffer(), dstOffset)) return;
 
-//  why ptrdiff?
-void Memory::DeviceLocalMapped::sync(VkDeviceSize size, ptrdiff_t offset)
-{
-    stagingBuffer->copyTo(memory.buffer(),
+    //  doesn't fit into the staging ring, so upload it through a dedicated buffer. Staged writes
+    //  to the same range are older and have to land first
+    memory.device.stagingRing().flush();
+
+    Buffer stagingBuffer(memory.device, Buffer::staging().size(size));
+    stagingBuffer
+        .allocateAndBindMemory(
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+        .lock()
+        ->map()
+        .lock()
+        ->write(src, size);
+    stagingBuffer.copyTo(memory.buffer(),
         {
-            .srcOffset = static_cast<VkDeviceSize>(offset),
-            .dstOffset = this->offset + static_cast<VkDeviceSize>(offset),
+            .srcOffset = 0,
+            .dstOffset = dstOffset,
             .size = size,
         });
 }
 
+//  the copies are recorded by the staging ring, nothing to do here
+void Memory::DeviceLocalMapped::sync(VkDeviceSize size, ptrdiff_t offset) {}
+
 Memory::HostVisibleMapped::HostVisibleMapped(
     const Memory& memory, VkMemoryMapFlags flags, VkDeviceSize offset)
     : Mapped(memory)
 {
-    ASSERT(vkMapMemory(memory.device, memory, offset, memory.size, flags, &data) == VK_SUCCESS);
+    if (memory.allocation.isValid())
+    {
+        //  sub-allocations share the persistent mapping of their block
+        data = static_cast<char*>(memory.allocation.block->map()) + memory.offset + offset;
+    }
+    else
+    {
+        ASSERT(
+            vkMapMemory(memory.device, memory, offset, memory.size, flags, &data) == VK_SUCCESS);
+    }
 }
 
 Memory::HostVisibleMapped::~HostVisibleMapped()
 {
-    vkUnmapMemory(memory.device, memory);
+    if (!memory.allocation.isValid()) vkUnmapMemory(memory.device, memory);
 }
 
 const void* Memory::HostVisibleMapped::read(VkDeviceSize size, ptrdiff_t offset) const
@@ -82,22 +139,21 @@ void Memory::HostVisibleMapped::write(const void* src, VkDeviceSize size, ptrdif
 
 void Memory::HostVisibleMapped::sync(VkDeviceSize size, ptrdiff_t offset)
 {
-    const auto atomSize = memory.device.physicalDeviceProperties().limits.nonCoherentAtomSize;
-
-    if (auto rem = offset % atomSize; rem != 0) offset = offset - rem;
+    if (memory.memoryType.propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) return;
 
-    //  TO DO: reorganize memory flushing
-    if (size < atomSize) size = atomSize;
-    else if (auto rem = size % atomSize; size > atomSize && size < memory.size && rem != 0)
-    {
-        size = size - rem + atomSize;
-    }
+    const auto [begin, end] = atomAlignedRange(memory, size, offset);
+    memory.markDirty(begin, end);
+}
 
-    if (size + offset > memory.size) size = memory.size - offset;
+void Memory::HostVisibleMapped::invalidate(VkDeviceSize size, ptrdiff_t offset)
+{
+    if (memory.memoryType.propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) return;
 
-    const auto range = MappedMemoryRange{}.memory(memory).offset(offset).size(size);
+    const auto [begin, end] = atomAlignedRange(memory, size, offset);
+    const auto range = MappedMemoryRange{}.memory(memory.handle()).offset(begin).size(end - begin);
 
-    vkFlushMappedMemoryRanges(memory.device, 1, &range);
+    ASSERT(vkInvalidateMappedMemoryRanges(memory.device, 1, &range) == VK_SUCCESS,
+        "failed to invalidate mapped memory");
 }
 
 Memory::Memory(Memory&& other) noexcept
@@ -105,14 +161,25 @@ Memory::Memory(Memory&& other) noexcept
     , device(other.device)
     , bindedResource(std::move(other.bindedResource))
     , size(std::move(other.size))
+    , offset(std::move(other.offset))
     , mapped(std::move(other.mapped))
     , memoryType(std::move(other.memoryType))
-{}
+    , allocation(std::exchange(other.allocation, {}))
+{
+    if (!other.dirtyRanges.empty())
+    {
+        device.forgetDirty(other);
+        dirtyRanges = std::move(other.dirtyRanges);
+        other.dirtyRanges.clear();
+        device.markDirty(*this);
+    }
+}
 
 Memory::Memory(const Device& device, MemoryAllocateInfo allocInfo, VkHandleType* handlePtr) noexcept
     : Handle(handlePtr)
     , device(device)
     , size(allocInfo.allocationSize())
+    , offset(0)
     , memoryType(device.memoryType(allocInfo.memoryTypeIndex()))
 {
     ASSERT(create(vkAllocateMemory, device, &allocInfo, nullptr) == VK_SUCCESS);
@@ -122,22 +189,39 @@ Memory::Memory(const Device& device, MemoryAllocateInfo allocInfo) noexcept
     : Memory(device, std::move(allocInfo), nullptr)
 {}
 
+Memory::Memory(const Device& device, vk::Allocator::Allocation allocation) noexcept
+    : Handle(allocation.block->memory().handle())
+    , device(device)
+    , size(allocation.size)
+    , offset(allocation.offset)
+    , memoryType(allocation.block->memory().memoryType)
+    , allocation(allocation)
+{}
+
 Memory::~Memory()
 {
+    if (!dirtyRanges.empty()) device.forgetDirty(*this);
+
     mapped.reset();
-    destroy(vkFreeMemory, device, handle(), nullptr);
+    if (allocation.isValid())
+    {
+        device.retire([&allocator = device.allocator(), allocation = allocation]() {
+            allocator.free(allocation);
+        });
+    }
+    retire(device, vkFreeMemory, device.handle(), handle(), nullptr);
 }
 
 bool Memory::bindImage(const Image& image, uint32_t offset)
 {
     bindedResource = &image;
-    return vkBindImageMemory(device, image, *this, offset) == VK_SUCCESS;
+    return vkBindImageMemory(device, image, *this, this->offset + offset) == VK_SUCCESS;
 }
 
 bool Memory::bindBuffer(const Buffer& buffer, uint32_t offset)
 {
     bindedResource = &buffer;
-    return vkBindBufferMemory(device, buffer, *this, offset) == VK_SUCCESS;
+    return vkBindBufferMemory(device, buffer, *this, this->offset + offset) == VK_SUCCESS;
 }
 
 const Buffer& Memory::buffer() const
@@ -179,5 +263,41 @@ void Memory::unmap()
     }
 }
 
+void Memory::markDirty(VkDeviceSize begin, VkDeviceSize end) const
+{
+    if (dirtyRanges.empty()) device.markDirty(*this);
+
+    //  the first range which overlaps or touches [begin, end), if any
+    auto first = std::lower_bound(dirtyRanges.begin(), dirtyRanges.end(), begin,
+        [](const auto& range, VkDeviceSize value) { return range.second < value; });
+
+    auto last = first;
+    for (; last != dirtyRanges.end() && last->first <= end; ++last)
+    {
+        begin = (std::min)(begin, last->first);
+        end = (std::max)(end, last->second);
+    }
+
+    if (first == last)
+    {
+        dirtyRanges.insert(first, { begin, end });
+    }
+    else
+    {
+        *first = { begin, end };
+        dirtyRanges.erase(first + 1, last);
+    }
+}
+
+void Memory::collectDirtyRanges(std::vector<VkMappedMemoryRange>& ranges) const
+{
+    for (const auto& [begin, end] : dirtyRanges)
+    {
+        ranges.push_back(MappedMemoryRange{}.memory(handle()).offset(begin).size(end - begin));
+    }
+
+    dirtyRanges.clear();
+}
+
 
 }}    //  namespace renderer::vk::handles
@@ -2,6 +2,7 @@
 
 #include "handle.hpp"
 
+#include "../allocator.hpp"
 #include "../utils.hpp"
 
 #include "buffer.hpp"
@@ -9,6 +10,7 @@
 
 #include <memory>
 #include <variant>
+#include <vector>
 
 namespace renderer::vk { namespace handles {
 
@@ -54,8 +56,10 @@ public:
         virtual void write(const void* src, VkDeviceSize size, ptrdiff_t offset = 0) override;
         virtual void sync(VkDeviceSize size, ptrdiff_t offset = 0) override;
 
-        std::unique_ptr<Buffer> stagingBuffer;
         VkDeviceSize offset;
+
+    private:
+        mutable std::vector<std::byte> readCache;
     };
 
     struct HostVisibleMapped : public Mapped
@@ -66,12 +70,15 @@ public:
         virtual const void* read(VkDeviceSize size, ptrdiff_t offset = 0) const override;
         virtual void write(const void* src, VkDeviceSize size, ptrdiff_t offset = 0) override;
         virtual void sync(VkDeviceSize size, ptrdiff_t offset = 0) override;
+        //  makes device writes visible to the host, the counterpart of sync
+        void invalidate(VkDeviceSize size, ptrdiff_t offset = 0);
 
         void* data;
     };
 
 public:
     Memory(const Device& buffer, MemoryAllocateInfo allocInfo) noexcept;
+    Memory(const Device& device, vk::Allocator::Allocation allocation) noexcept;
     Memory(Memory&& other) noexcept;
     virtual ~Memory();
 
@@ -84,8 +91,15 @@ public:
     std::weak_ptr<Mapped> map(VkMemoryMapFlags flags = 0, VkDeviceSize offset = 0);
     void unmap();
 
+    //  dirty ranges of non coherent memory are merged here and flushed all at once by
+    //  Device::flushMappedMemory, both offsets are relative to the device memory
+    void markDirty(VkDeviceSize begin, VkDeviceSize end) const;
+    void collectDirtyRanges(std::vector<VkMappedMemoryRange>& ranges) const;
+
     const Device& device;
     VkDeviceSize size;
+    //  offset of the range inside of the device memory, non zero for sub-allocations
+    VkDeviceSize offset;
     std::shared_ptr<Mapped> mapped;
     VkMemoryType memoryType;
 
@@ -94,6 +108,9 @@ protected:
 
 private:
     std::variant<const Buffer*, const Image*> bindedResource;
+    vk::Allocator::Allocation allocation;
+    //  sorted and disjoint [begin, end) ranges
+    mutable std::vector<std::pair<VkDeviceSize, VkDeviceSize>> dirtyRanges;
 };
 
 }}    //  namespace renderer::vk::handles
@@ -19,7 +19,7 @@ Pipeline::Pipeline(const Device& device, VkPipelineCache cache, VkHandleType* ha
 
 Pipeline::~Pipeline()
 {
-    destroy(vkDestroyPipeline, m_device, handle(), nullptr);
+    retire(m_device, vkDestroyPipeline, m_device.handle(), handle(), nullptr);
 }
 
 }}    //  namespace renderer::vk::handles
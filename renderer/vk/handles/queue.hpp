@@ -17,6 +17,15 @@ BEGIN_DECLARE_VKSTRUCT(SubmitInfo, VK_STRUCTURE_TYPE_SUBMIT_INFO)
     VKSTRUCT_PROPERTY(const VkSemaphore*, pSignalSemaphores)
 END_DECLARE_VKSTRUCT()
 
+BEGIN_DECLARE_VKSTRUCT(TimelineSemaphoreSubmitInfo,
+    VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO)
+    VKSTRUCT_PROPERTY(const void*, pNext)
+    VKSTRUCT_PROPERTY(uint32_t, waitSemaphoreValueCount)
+    VKSTRUCT_PROPERTY(const uint64_t*, pWaitSemaphoreValues)
+    VKSTRUCT_PROPERTY(uint32_t, signalSemaphoreValueCount)
+    VKSTRUCT_PROPERTY(const uint64_t*, pSignalSemaphoreValues)
+END_DECLARE_VKSTRUCT()
+
 BEGIN_DECLARE_VKSTRUCT(PresentInfoKHR, VK_STRUCTURE_TYPE_PRESENT_INFO_KHR)
     VKSTRUCT_PROPERTY(const void*, pNext)
     VKSTRUCT_PROPERTY(uint32_t, waitSemaphoreCount)
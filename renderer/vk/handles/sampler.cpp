@@ -23,7 +23,7 @@ Sampler::Sampler(const Device& device, SamplerCreateInfo createInfo) noexcept
 
 Sampler::~Sampler()
 {
-	destroy(vkDestroySampler, m_device, handle(), nullptr);
+	retire(m_device, vkDestroySampler, m_device.handle(), handle(), nullptr);
 }
 
 }}    //  namespace renderer::vk::handles
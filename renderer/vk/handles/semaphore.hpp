@@ -11,6 +11,20 @@ BEGIN_DECLARE_VKSTRUCT(SemaphoreCreateInfo, VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_I
     VKSTRUCT_PROPERTY(VkSemaphoreCreateFlags, flags)
 END_DECLARE_VKSTRUCT()
 
+BEGIN_DECLARE_VKSTRUCT(SemaphoreTypeCreateInfo, VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO)
+    VKSTRUCT_PROPERTY(const void*, pNext)
+    VKSTRUCT_PROPERTY(VkSemaphoreType, semaphoreType)
+    VKSTRUCT_PROPERTY(uint64_t, initialValue)
+END_DECLARE_VKSTRUCT()
+
+BEGIN_DECLARE_VKSTRUCT(SemaphoreWaitInfo, VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO)
+    VKSTRUCT_PROPERTY(const void*, pNext)
+    VKSTRUCT_PROPERTY(VkSemaphoreWaitFlags, flags)
+    VKSTRUCT_PROPERTY(uint32_t, semaphoreCount)
+    VKSTRUCT_PROPERTY(const VkSemaphore*, pSemaphores)
+    VKSTRUCT_PROPERTY(const uint64_t*, pValues)
+END_DECLARE_VKSTRUCT()
+
 class Device;
 
 class Semaphore : public Handle<VkSemaphore>
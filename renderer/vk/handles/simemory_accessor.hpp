@@ -1,5 +1,7 @@
 #pragma once
 
+#include <optional>
+
 namespace renderer::vk { namespace handles {
 
 class Device;
@@ -9,7 +11,7 @@ template <typename Impl>
 class SIMemoryAccessor
 {
 protected:
-    static uint32_t findMemoryType(
+    static std::optional<uint32_t> tryFindMemoryType(
         VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties)
     {
         VkPhysicalDeviceMemoryProperties memProperties;
@@ -24,8 +26,16 @@ protected:
             }
         }
 
-        ASSERT(false, "failed to find suitable memory type!");
-        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        return std::nullopt;
+    }
+
+    static uint32_t findMemoryType(
+        VkPhysicalDevice physicalDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties)
+    {
+        const auto memoryType = tryFindMemoryType(physicalDevice, typeFilter, properties);
+        ASSERT(memoryType.has_value(), "failed to find suitable memory type!");
+
+        return memoryType.value_or(0);
     }
 
 public:
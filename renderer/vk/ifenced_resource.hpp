@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+namespace renderer::vk {
+
+//  Holds on to what submissions use until their fences have been waited for. Targets hand the
+//  fences of their submissions to every resource through Device::recordFence and releaseFence, so
+//  none of them is left holding a fence which is never released
+class IFencedResource
+{
+public:
+    virtual ~IFencedResource() {}
+
+    //  hands what was used since the last call to the fence of the submission. Resources tagging
+    //  their commands with the fence as they are recorded have nothing to do here
+    virtual void record(VkFence fence) {}
+    //  the fence has been waited for, what was handed to it may be reused
+    virtual void release(VkFence fence) = 0;
+
+    //  used by render passes only, compute submissions recorded in the middle of a pass leave it
+    //  to the submission of the pass
+    virtual bool renderPassOnly() const { return false; }
+};
+
+}    //  namespace renderer::vk
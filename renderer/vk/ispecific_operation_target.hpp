@@ -8,6 +8,7 @@ class IOperationTarget;
 namespace vk {
 
 class OperationContext;
+class TransientDescriptorAllocator;
 
 class ISpecificOperationTarget
 {
@@ -19,6 +20,8 @@ public:
     virtual void populateWaitInfo(OperationContext& context) = 0;
     virtual void waitFor(OperationContext& context) = 0;
     virtual uint32_t descriptorsRequired() const = 0;
+    //  the sets of PER_FRAME containers, handed to the fences of the submissions of the target
+    virtual TransientDescriptorAllocator& transientDescriptorAllocator() = 0;
 };
 
 template <typename Base>
@@ -1,9 +1,14 @@
 #include "model.hpp"
 
+#include "handles/buffer.hpp"
 #include "handles/command_buffer.hpp"
 #include "handles/memory.hpp"
 
 #include "graphics_context.hpp"
+#include "uniform_arena.hpp"
+#include "upload_manager.hpp"
+
+#include <algorithm>
 
 namespace renderer::vk {
 
@@ -17,16 +22,50 @@ Model::Model(GraphicsContext& context, CreateInfo createInfo)
     m_memory = context.fetchMemory(m_verticesSize + m_indicesSize,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
 			VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-	auto mapped = m_memory.lock()->map();
-    mapped.lock()->write(createInfo.vertices.data(), m_verticesSize, 0);
-    mapped.lock()->write(createInfo.indices.data(), m_indicesSize, m_verticesSize);
-    mapped.lock()->sync(m_verticesSize + m_indicesSize, 0);
-	m_memory.lock()->unmap();
+
+    auto& uploadManager = m_context.device().uploadManager();
+    const VkBuffer buffer = m_memory.lock()->buffer();
+    uploadManager.upload(createInfo.vertices.data(), m_verticesSize, buffer, 0);
+    uploadManager.upload(createInfo.indices.data(), m_indicesSize, buffer, m_verticesSize);
+}
+
+uint32_t Model::indexCount() const
+{
+    return m_indicesSize / m_indexSize;
 }
 
 void Model::draw(renderer::OperationContext& context)
 {
-    get(context).commandBuffer->drawIndexed(m_indicesSize / m_indexSize, 1, 0, 0, 0);
+    get(context).commandBuffer->drawIndexed(indexCount(), 1, 0, 0, 0);
+}
+
+void Model::drawInstanced(
+    renderer::OperationContext& context, std::span<const glm::mat4> transforms)
+{
+    constexpr uint32_t instanceBinding = 1;
+    constexpr size_t maxInstances = UniformArena::s_blockSize / sizeof(glm::mat4);
+
+    auto& arena = m_context.device().uniformArena();
+    auto& commandBuffer = *get(context).commandBuffer;
+    for (size_t first = 0; first < transforms.size(); first += maxInstances)
+    {
+        const auto instances =
+            transforms.subspan(first, (std::min)(maxInstances, transforms.size() - first));
+
+        UniformArena::Slice slice;
+        VkBuffer buffer;
+        {
+            //  the arena is shared by the task contexts of a parallel record, pushes from other
+            //  tasks may add blocks, so the buffer is looked up under the lock too
+            const auto lock = context.lockBindings();
+            slice = arena.push(instances.data(), instances.size_bytes());
+            buffer = arena.buffer(slice).handle();
+        }
+
+        const VkDeviceSize offsets[] = { slice.offset };
+        commandBuffer.bindVertexBuffer(instanceBinding, 1, &buffer, offsets);
+        commandBuffer.drawIndexed(indexCount(), instances.size(), 0, 0, 0);
+    }
 }
 
 void Model::bind(renderer::OperationContext& context)
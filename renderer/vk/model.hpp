@@ -23,8 +23,12 @@ public:
 public:
     Model(GraphicsContext& context, IModel::CreateInfo createInfo);
 
+    virtual uint32_t indexCount() const override;
+
     virtual void draw(renderer::OperationContext& context) override;
     virtual void bind(renderer::OperationContext& context) override;
+    virtual void drawInstanced(renderer::OperationContext& context,
+        std::span<const glm::mat4> transforms) override;
 
 private:
     GraphicsContext& m_context;
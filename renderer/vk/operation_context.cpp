@@ -1,13 +1,17 @@
 #include "operation_context.hpp"
 
 #include "handles/command_buffer.hpp"
+#include "handles/device.hpp"
+#include "handles/framebuffer.hpp"
 #include "handles/render_pass.hpp"
 
+#include "command_bundle.hpp"
 #include "graphics_pipeline.hpp"
 #include "renderer.hpp"
 #include "computer.hpp"
 #include "compute_pipeline.hpp"
 #include "ispecific_operation_target.hpp"
+#include "secondary_recorder.hpp"
 
 #include <vulkan/vulkan_core.h>
 #include <operation_context.hpp>
@@ -34,6 +38,10 @@ OperationContext::OperationContext(OperationContext&& other)
     , computer(std::move(other.computer))
     , renderPass(std::move(other.renderPass))
     , mainTarget(std::move(other.mainTarget))
+    , secondaryContents(other.secondaryContents)
+    , bindMutex(other.bindMutex)
+    , viewport(std::move(other.viewport))
+    , scissor(std::move(other.scissor))
 {
     other.renderer = nullptr;
     other.computer = nullptr;
@@ -100,12 +108,93 @@ void OperationContext::waitForOperation(OperationContext& other)
 
 void OperationContext::setScissors(Scissors scissors) const
 {
+    if (secondaryContents)
+    {
+        scissor = toVkScissors(scissors);
+        return;
+    }
+
     commandBuffer->setScissor(toVkScissors(scissors));
 }
 
 void OperationContext::setViewport(Viewport viewport) const
 {
+    if (secondaryContents)
+    {
+        this->viewport = toVkViewport(viewport);
+        return;
+    }
+
     commandBuffer->setViewport(toVkViewport(viewport));
 }
 
+void OperationContext::record(renderer::OperationContext& context,
+    std::span<const std::function<void(renderer::OperationContext&)>> tasks)
+{
+    if (!secondaryContents)
+    {
+        for (const auto& task : tasks)
+        {
+            task(context);
+        }
+        return;
+    }
+
+    const auto inheritanceInfo =
+        handles::CommandBufferInheritanceInfo{}
+            .renderPass(*renderPass)
+            .subpass(0)
+            .framebuffer(*framebuffer);
+    const auto beginInfo =
+        handles::CommandBufferBeginInfo{}
+            .flags(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT)
+            .pInheritanceInfo(&inheritanceInfo);
+
+    std::mutex mutex;
+    const auto commandBuffers = renderer->device().secondaryRecorder().run(tasks.size(),
+        [&](uint32_t task, handles::CommandBuffer& taskCommandBuffer) {
+            ASSERT(taskCommandBuffer.begin(beginInfo) == VK_SUCCESS,
+                "failed to begin recording secondary command buffer!");
+
+            renderer::OperationContext taskContext;
+            auto& specContext = taskContext.emplace<vk::OperationContext>(renderer);
+            specContext.framebuffer = framebuffer;
+            specContext.renderPass = renderPass;
+            specContext.specificTarget = specificTarget;
+            specContext.mainTarget = mainTarget;
+            specContext.commandBuffer = &taskCommandBuffer;
+            specContext.bindMutex = &mutex;
+
+            if (viewport) taskCommandBuffer.setViewport(*viewport);
+            if (scissor) taskCommandBuffer.setScissor(*scissor);
+
+            tasks[task](taskContext);
+
+            ASSERT(taskCommandBuffer.end() == VK_SUCCESS,
+                "failed to record secondary command buffer!");
+        });
+
+    commandBuffer->executeCommands(commandBuffers);
+}
+
+void OperationContext::replay(renderer::OperationContext& context, ICommandBundle& bundle,
+    const std::function<void(renderer::OperationContext&)>& record)
+{
+    if (!secondaryContents)
+    {
+        record(context);
+        return;
+    }
+
+    const VkCommandBuffer bundleCommandBuffer =
+        static_cast<CommandBundle&>(bundle).prepare(context, record);
+    commandBuffer->executeCommands({ &bundleCommandBuffer, 1 });
+}
+
+std::unique_lock<std::mutex> OperationContext::lockBindings() const
+{
+    return bindMutex ? std::unique_lock{ *bindMutex } : std::unique_lock<std::mutex>{};
+}
+
 }    //  namespace renderer::vk
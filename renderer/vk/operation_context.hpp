@@ -5,12 +5,17 @@
 
 #include <types.hpp>
 
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
 namespace renderer {
 
 struct OperationContext;
+class ICommandBundle;
 
 class IPipeline;
 class IOperationTarget;
@@ -50,6 +55,11 @@ struct OperationContext
     void waitForOperation(OperationContext& other);
     void setScissors(Scissors scissors) const;
     void setViewport(Viewport viewport) const;
+    void record(renderer::OperationContext& context,
+        std::span<const std::function<void(renderer::OperationContext&)>> tasks);
+    void replay(renderer::OperationContext& context, ICommandBundle& bundle,
+        const std::function<void(renderer::OperationContext&)>& record);
+    std::unique_lock<std::mutex> lockBindings() const;
 
     std::vector<VkSemaphore> waitSemaphores;
     handles::Framebuffer* framebuffer = nullptr;
@@ -62,6 +72,14 @@ struct OperationContext
     Renderer* renderer = nullptr;
     Computer* computer = nullptr;
     handles::RenderPass* renderPass = nullptr;
+
+    //  the render pass was begun for secondary command buffers, it takes no inline commands
+    bool secondaryContents = false;
+    //  shared by the contexts recording in parallel, null otherwise
+    std::mutex* bindMutex = nullptr;
+    //  secondary command buffers don't inherit dynamic state, it is set in every one of them
+    mutable std::optional<VkViewport> viewport;
+    mutable std::optional<VkRect2D> scissor;
 };
 
 }    //  namespace vk
@@ -4,16 +4,47 @@
 #include "handles/descriptor_pool.hpp"
 #include "handles/descriptor_set.hpp"
 #include "handles/descriptor_set_layout.hpp"
+#include "handles/descriptor_update_template.hpp"
 #include "handles/pipeline_layout.hpp"
 
 #include "descriptor_set_provider.hpp"
 #include "graphics_context.hpp"
 #include "ispecific_operation_target.hpp"
+#include "transient_descriptor_allocator.hpp"
+#include "bindless_texture_table.hpp"
+
+#include <texture_table.hpp>
 
 #include <algorithm>
 
 namespace renderer::vk {
 
+//  a stage may appear in a single range of the layout, so each stage gets one range covering all
+//  the bindings it reads
+static void mergePushConstantRange(
+    std::vector<VkPushConstantRange>& merged, const VkPushConstantRange& range)
+{
+    for (VkShaderStageFlags stages = range.stageFlags; stages; stages &= stages - 1)
+    {
+        const VkShaderStageFlags stage = stages & ~(stages - 1);
+        auto iter = std::find_if(merged.begin(), merged.end(),
+            [&](const auto& stageRange) { return stageRange.stageFlags == stage; });
+        if (iter == merged.end())
+        {
+            merged.push_back(VkPushConstantRange{
+                .stageFlags = stage,
+                .offset = range.offset,
+                .size = range.size,
+            });
+            continue;
+        }
+
+        const uint32_t end = std::max(iter->offset + iter->size, range.offset + range.size);
+        iter->offset = std::min(iter->offset, range.offset);
+        iter->size = end - iter->offset;
+    }
+}
+
 ShaderInterfaceHandle::TypeVisitor Pipeline::s_handleVisitor;
 
 Pipeline::BindContext::BindContext(DescriptorSetInfo descriptorSetInfo)
@@ -25,80 +56,163 @@ void Pipeline::BindContext::bind(renderer::OperationContext& context,
 {
     const uint32_t descriptorsRequired = get(context).specificTarget->descriptorsRequired();
 
-    std::span descriptors = container.uniforms();
-    std::vector<ShaderResource::Descriptor::Id> keyVector;
-    keyVector.reserve(descriptors.size());
-    for (const auto& descriptor : descriptors)
+    m_key.clear();
+    m_dynamicOffsetCount = 0;
+    m_pushConstantCount = 0;
+
+    if (descriptorSetInfo.textureTable)
     {
-        DASSERT(!descriptor.handle.expired(),
+        currentSet = descriptorSetInfo.textureTable->set();
+        return;
+    }
+
+    std::span uniforms = container.uniforms();
+    DASSERT(uniforms.size() <= DescriptorSetKey::s_capacity, "too many descriptors in a set");
+
+    uint32_t descriptorCount = 0;
+    for (size_t i = 0; i < uniforms.size(); ++i)
+    {
+        DASSERT(!uniforms[i].handle.expired(),
             "descriptor handle is expired or was not initialized");
-        descriptor.handle.lock()->accept(s_handleVisitor);
+        uniforms[i].handle.lock()->accept(s_handleVisitor);
+
+        if (uniforms[i].binding.type == ShaderBlockType::PUSH_CONSTANT)
+        {
+            //  recorded by the derived context, never part of the descriptor set
+            m_pushConstants[m_pushConstantCount++] = &*s_handleVisitor;
+            continue;
+        }
 
-        s_handleVisitor->assureDescriptorCount(descriptorsRequired);
+        s_handleVisitor->prepare(descriptorsRequired);
 
-        const auto id = s_handleVisitor->currentDescriptor()->id;
+        auto& descriptor = *s_handleVisitor->currentDescriptor();
+        m_descriptors[descriptorCount++] = &descriptor;
 
-        if (descriptor.binding.type == ShaderBlockType::UNIFORM_DYNAMIC)
+        if (uniforms[i].binding.type == ShaderBlockType::UNIFORM_DYNAMIC)
         {
-            keyVector.push_back({
+            m_key.push({
                 //  dynamic descriptors use dynamic offsets and can
                 //  share same descriptor set given the same buffer ID
                 .descriptorId = 0,
-                .bufferId = id.bufferId,
-                .resourceId = id.resourceId,
+                .bufferId = descriptor.id.bufferId,
+                .resourceId = descriptor.id.resourceId,
             });
+            m_dynamicOffsets[m_dynamicOffsetCount++] = descriptor.dynamicOffset;
         }
         else
         {
-            keyVector.push_back(id);
+            m_key.push(descriptor.id);
         }
     }
 
-    if (auto iter = sets.find(keyVector); iter != sets.end())
+    DASSERT(m_pushConstantCount == descriptorSetInfo.pushConstantRanges.size(),
+        "container push constants do not match its layout");
+
+    if (descriptorCount == 0)
     {
-        currentSet = iter->second;
+        currentSet = nullptr;
+        return;
     }
-    else
+
+    auto* allocator = descriptorSetInfo.transient ?
+        &get(context).specificTarget->transientDescriptorAllocator() :
+        nullptr;
+    if (allocator)
     {
-        std::vector<handles::DescriptorSet::Write> writes;
-        for (uint32_t i = 0; i < descriptors.size(); ++i)
+        if (allocator != setsAllocator || allocator->epoch() != setsEpoch)
         {
-            descriptors[i].handle.lock()->accept(s_handleVisitor);
-            if (descriptors[i].binding.type == ShaderBlockType::SAMPLER)
-            {
-                writes.push_back(handles::DescriptorSet::Write{
-                    .imageInfo = s_handleVisitor->currentDescriptor()->descriptorImageInfo,
-                    .layoutBinding = descriptorSetInfo.descriptorSetLayout.binding(
-                        descriptorSetInfo.bindingIndices[i]),
-                });
-            }
-            else
-            {
-                writes.push_back(handles::DescriptorSet::Write{
-                    .bufferInfo = s_handleVisitor->currentDescriptor()->descriptorBufferInfo,
-                    .layoutBinding = descriptorSetInfo.descriptorSetLayout.binding(
-                        descriptorSetInfo.bindingIndices[i]),
-                });
-            }
+            sets.clear();
+            setsAllocator = allocator;
+            setsEpoch = allocator->epoch();
+        }
+        allocator->countUse();
+    }
+
+    if (auto* set = sets.find(m_key); set)
+    {
+        currentSet = *set;
+        return;
+    }
+
+    for (size_t i = 0, descriptorIndex = 0; i < uniforms.size(); ++i)
+    {
+        if (uniforms[i].binding.type == ShaderBlockType::PUSH_CONSTANT) continue;
+
+        if (uniforms[i].binding.type == ShaderBlockType::SAMPLER)
+        {
+            m_updateInfos[descriptorIndex].imageInfo =
+                m_descriptors[descriptorIndex]->descriptorImageInfo;
+        }
+        else
+        {
+            m_updateInfos[descriptorIndex].bufferInfo =
+                m_descriptors[descriptorIndex]->descriptorBufferInfo;
         }
+        ++descriptorIndex;
+    }
 
-        auto [newEl, _] = sets.emplace(keyVector,
-            descriptorSetInfo.descriptorSetProvider.set(descriptorSetInfo.descriptorSetLayout));
-        newEl->second->write(writes);
-        currentSet = newEl->second;
+    currentSet = sets.insert(m_key,
+        allocator ?
+            allocator->allocate(descriptorSetInfo.descriptorSetLayout) :
+            descriptorSetInfo.descriptorSetProvider->set(descriptorSetInfo.descriptorSetLayout));
+    currentSet->write(*descriptorSetInfo.updateTemplate, m_updateInfos.data());
+}
+
+void Pipeline::BindContext::pushConstants(const handles::CommandBuffer& commandBuffer,
+    const handles::PipelineLayout& layout) const
+{
+    for (uint32_t i = 0; i < m_pushConstantCount; ++i)
+    {
+        const auto& range = descriptorSetInfo.pushConstantRanges[i];
+        commandBuffer.pushConstants(layout, range.stageFlags, range.offset, range.size,
+            m_pushConstants[i]->pushConstants().data());
     }
 }
 
 void Pipeline::init(const std::vector<InterfaceContainerInfo>& interfaceContainers)
 {
     std::vector<VkDescriptorSetLayout> layouts;
+    std::vector<VkPushConstantRange> pushConstantRanges;
     uint32_t bindingId = 0;
+    uint32_t pushConstantOffset = 0;
     for (auto& containerInfo : interfaceContainers)
     {
+        if (std::any_of(containerInfo.layout.begin(), containerInfo.layout.end(),
+                [](const auto& binding) { return binding.type == ShaderBlockType::TEXTURE_TABLE; }))
+        {
+            DASSERT(containerInfo.layout.size() == 1,
+                "texture table has to be the only binding of its container");
+            DASSERT(containerInfo.layout.front().stage == TextureTable::s_layout.front().stage,
+                "the device table is laid out for the stage of TextureTable");
+            auto* table = m_context.device().bindlessTextureTable();
+            ASSERT(table, "bindless textures are not supported by the device");
+
+            m_textureTableSets[containerInfo.id] = layouts.size();
+            layouts.push_back(table->layout());
+            continue;
+        }
+
         std::vector<handles::DescriptorPoolSize> poolSizes;
         std::vector<handles::DescriptorSetLayoutBinding> setLayoutBindings;
+        std::vector<VkDescriptorUpdateTemplateEntry> updateEntries;
         for (auto& uniform : containerInfo.layout)
         {
+            if (uniform.type == ShaderBlockType::PUSH_CONSTANT)
+            {
+                //  ranges of all containers share one block, laid out back to back
+                DASSERT(uniform.size > 0 && uniform.size % 4 == 0,
+                    "push constant size must be a non zero multiple of 4");
+                const VkPushConstantRange range{
+                    .stageFlags = toShaderStageFlags(uniform.stage),
+                    .offset = pushConstantOffset,
+                    .size = uniform.size,
+                };
+                m_pushConstantRanges[containerInfo.id].push_back(range);
+                mergePushConstantRange(pushConstantRanges, range);
+                pushConstantOffset += uniform.size;
+                continue;
+            }
+
             const auto type = toDescriptorType(uniform.type);
             setLayoutBindings.push_back(
                 handles::DescriptorSetLayoutBinding{}
@@ -107,20 +221,35 @@ void Pipeline::init(const std::vector<InterfaceContainerInfo>& interfaceContaine
                     .descriptorType(type)
                     .stageFlags(toShaderStageFlags(uniform.stage)));
 
+            //  one packed DescriptorUpdateInfo per binding, in the order bind fills them
+            updateEntries.push_back(VkDescriptorUpdateTemplateEntry{
+                .dstBinding = bindingId,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = type,
+                .offset = updateEntries.size() * sizeof(handles::DescriptorUpdateInfo),
+                .stride = sizeof(handles::DescriptorUpdateInfo),
+            });
+
             m_bindingIndices[containerInfo.id].push_back(bindingId++);
 
             poolSizes.push_back(
                 handles::DescriptorPoolSize{}.type(type).descriptorCount(containerInfo.batchSize));
         }
 
-        m_descriptorSetProviders.emplace(std::piecewise_construct,
-            std::forward_as_tuple(containerInfo.id),
-            std::forward_as_tuple(m_context,
-                handles::DescriptorPoolCreateInfo{}
-                    .maxSets(containerInfo.batchSize)
-                    .poolSizeCount(poolSizes.size())
-                    .pPoolSizes(poolSizes.data())
-                    .flags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)));
+        m_descriptorLifetimes[containerInfo.id] = containerInfo.lifetime;
+
+        if (!poolSizes.empty())
+        {
+            m_descriptorSetProviders.emplace(std::piecewise_construct,
+                std::forward_as_tuple(containerInfo.id),
+                std::forward_as_tuple(m_context,
+                    handles::DescriptorPoolCreateInfo{}
+                        .maxSets(containerInfo.batchSize)
+                        .poolSizeCount(poolSizes.size())
+                        .pPoolSizes(poolSizes.data())
+                        .flags(VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT)));
+        }
 
         const auto& [iter, _] = m_setLayouts.emplace(containerInfo.id,
             std::pair{ layouts.size(),
@@ -129,14 +258,48 @@ void Pipeline::init(const std::vector<InterfaceContainerInfo>& interfaceContaine
                         .bindingCount(setLayoutBindings.size())
                         .pBindings(setLayoutBindings.data())) });
         layouts.push_back(iter->second.second);
+
+        if (!updateEntries.empty())
+        {
+            m_updateTemplates.emplace(std::piecewise_construct,
+                std::forward_as_tuple(containerInfo.id),
+                std::forward_as_tuple(m_context.device(),
+                    handles::DescriptorUpdateTemplateCreateInfo{}
+                        .descriptorUpdateEntryCount(updateEntries.size())
+                        .pDescriptorUpdateEntries(updateEntries.data())
+                        .templateType(VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET)
+                        .descriptorSetLayout(iter->second.second)));
+        }
+    }
+
+    ASSERT(pushConstantOffset <=
+            m_context.device().physicalDeviceProperties().limits.maxPushConstantsSize,
+        "push constants exceed device limit");
+
+    //  the bindings keep their own bytes, but an update has to name every stage whose range
+    //  overlaps them. Merged ranges span whole bindings, so overlapping means containing
+    for (auto& [_, ranges] : m_pushConstantRanges)
+    {
+        for (auto& range : ranges)
+        {
+            range.stageFlags = 0;
+            for (const auto& stageRange : pushConstantRanges)
+            {
+                if (stageRange.offset < range.offset + range.size &&
+                    range.offset < stageRange.offset + stageRange.size)
+                {
+                    range.stageFlags |= stageRange.stageFlags;
+                }
+            }
+        }
     }
 
     m_pipelineLayout = std::make_unique<handles::PipelineLayout>(m_context.device(),
         handles::PipelineLayoutCreateInfo{}
             .setLayoutCount(layouts.size())
             .pSetLayouts(layouts.data())
-            //  TO DO: push constants impl
-            .pushConstantRangeCount(0));
+            .pushConstantRangeCount(pushConstantRanges.size())
+            .pPushConstantRanges(pushConstantRanges.data()));
 }
 
 Pipeline::~Pipeline()
@@ -156,14 +319,42 @@ FragileSharedPtr<IPipelineBindContext> Pipeline::bindContext(
         return iter->second;
     }
 
+    if (auto iter = m_textureTableSets.find(containerId); iter != m_textureTableSets.end())
+    {
+        auto* table = m_context.device().bindlessTextureTable();
+        auto [contextIter, _] = m_bindContexts.emplace(containerTypeId,
+            newBindContext({
+                .setId = iter->second,
+                .bindingIndices = m_bindingIndices[containerId],
+                .descriptorSetLayout = table->layout(),
+                .textureTable = table,
+            }));
+        contextIter->second.setFragile(true);
+
+        return contextIter->second;
+    }
+
     auto& [setId, layout] = m_setLayouts.at(containerId);
+    auto providerIter = m_descriptorSetProviders.find(containerId);
+    auto templateIter = m_updateTemplates.find(containerId);
+    std::span<const VkPushConstantRange> pushConstantRanges;
+    if (auto iter = m_pushConstantRanges.find(containerId); iter != m_pushConstantRanges.end())
+    {
+        pushConstantRanges = iter->second;
+    }
 
     auto [contextIter, _] = m_bindContexts.emplace(containerTypeId, 
         newBindContext({
             .setId = setId,
-            .bindingIndices = m_bindingIndices.at(containerId),
-            .descriptorSetProvider = m_descriptorSetProviders.at(containerId),
+            .bindingIndices = m_bindingIndices[containerId],
+            .descriptorSetProvider = providerIter != m_descriptorSetProviders.end() ?
+                &providerIter->second :
+                nullptr,
             .descriptorSetLayout = layout,
+            .transient = m_descriptorLifetimes.at(containerId) == DescriptorLifetime::PER_FRAME,
+            .pushConstantRanges = pushConstantRanges,
+            .updateTemplate =
+                templateIter != m_updateTemplates.end() ? &templateIter->second : nullptr,
     }));
 
     contextIter->second.setFragile(true);
@@ -2,9 +2,11 @@
 
 #include <ishader_interface.hpp>
 #include "shader_interface_handle.hpp"
+#include "descriptor_set_cache.hpp"
 
 #include "handles/descriptor_set.hpp"
 #include "handles/descriptor_set_layout.hpp"
+#include "handles/descriptor_update_template.hpp"
 
 #include <utils.hpp>
 #include <ipipeline.hpp>
@@ -19,10 +21,13 @@ class Renderer;
 class OperationContext;
 class GraphicsContext;
 class DescriptorSetProvider;
+class TransientDescriptorAllocator;
+class BindlessTextureTable;
 
 class ShaderInterfaceHandle;
 
 namespace handles {
+class CommandBuffer;
 class Pipeline;
 class PipelineLayout;
 class RenderPass;
@@ -37,8 +42,19 @@ protected:
         {
             uint32_t setId = 0;
             std::vector<uint32_t>& bindingIndices;
-            DescriptorSetProvider& descriptorSetProvider;
-            handles::DescriptorSetLayout& descriptorSetLayout;
+            //  null for containers made of push constants only
+            DescriptorSetProvider* descriptorSetProvider = nullptr;
+            const handles::DescriptorSetLayout& descriptorSetLayout;
+            //  DescriptorLifetime::PER_FRAME containers take their sets from the allocator of the
+            //  operation target
+            bool transient = false;
+            //  one per PUSH_CONSTANT binding, in layout order, flagged with the stages of every
+            //  layout range overlapping it
+            std::span<const VkPushConstantRange> pushConstantRanges;
+            //  set for TEXTURE_TABLE containers only, its set is bound as is
+            BindlessTextureTable* textureTable = nullptr;
+            //  null for containers without descriptors
+            const handles::DescriptorUpdateTemplate* updateTemplate = nullptr;
         };
 
         BindContext(DescriptorSetInfo descriptorSetInfo);
@@ -46,13 +62,33 @@ protected:
         virtual void bind(renderer::OperationContext& context,
             const IShaderInterfaceContainer& container) override;
 
+    protected:
+        //  in binding order, as vkCmdBindDescriptorSets expects them
+        std::span<const uint32_t> dynamicOffsets() const
+        {
+            return { m_dynamicOffsets.data(), m_dynamicOffsetCount };
+        }
+
+        void pushConstants(const handles::CommandBuffer& commandBuffer,
+            const handles::PipelineLayout& layout) const;
+
     protected:
         DescriptorSetInfo descriptorSetInfo;
         std::shared_ptr<handles::DescriptorSet> currentSet;
-        std::unordered_map<std::vector<ShaderResource::Descriptor::Id>,
-            std::shared_ptr<handles::DescriptorSet>,
-            ShaderResource::Descriptor::Id::ContainerHasher<std::vector>>
-            sets;
+        DescriptorSetCache sets;
+        //  transient sets are valid for the submission they were allocated for only
+        const TransientDescriptorAllocator* setsAllocator = nullptr;
+        uint64_t setsEpoch = 0;
+
+    private:
+        //  scratch state of the last bind, kept inline so binding never allocates
+        DescriptorSetKey m_key;
+        std::array<ShaderResource::Descriptor*, DescriptorSetKey::s_capacity> m_descriptors;
+        std::array<uint32_t, DescriptorSetKey::s_capacity> m_dynamicOffsets;
+        std::array<handles::DescriptorUpdateInfo, DescriptorSetKey::s_capacity> m_updateInfos;
+        uint32_t m_dynamicOffsetCount = 0;
+        std::array<const ShaderInterfaceHandle*, DescriptorSetKey::s_capacity> m_pushConstants;
+        uint32_t m_pushConstantCount = 0;
     };
 
 public:
@@ -82,11 +118,16 @@ protected:
     std::unordered_map<uint32_t, DescriptorSetProvider> m_descriptorSetProviders;
     FragileSharedPtrMap<std::type_index, IPipelineBindContext> m_bindContexts;
     std::unordered_map<uint32_t, std::pair<uint32_t, handles::DescriptorSetLayout>> m_setLayouts;
+    std::unordered_map<uint32_t, handles::DescriptorUpdateTemplate> m_updateTemplates;
 
     std::unique_ptr<handles::PipelineLayout> m_pipelineLayout;
 
     std::unordered_map<uint32_t, std::vector<uint32_t>> m_bindingIndices;
+    std::unordered_map<uint32_t, DescriptorLifetime> m_descriptorLifetimes;
     std::unordered_map<uint32_t, uint32_t> m_descriptorsCount;
+    std::unordered_map<uint32_t, std::vector<VkPushConstantRange>> m_pushConstantRanges;
+    //  set index of each TEXTURE_TABLE container, they use the layout of the device table
+    std::unordered_map<uint32_t, uint32_t> m_textureTableSets;
 
     std::vector<VkVertexInputBindingDescription> m_bindingDescriptions;
     std::vector<VkVertexInputAttributeDescription> m_attributeDescriptions;
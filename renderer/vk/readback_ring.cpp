@@ -0,0 +1,217 @@
+#include "readback_ring.hpp"
+
+#include "handles/buffer.hpp"
+#include "handles/command_buffer.hpp"
+#include "handles/device.hpp"
+#include "handles/memory.hpp"
+
+#include <cstring>
+
+namespace renderer::vk {
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static handles::Memory::HostVisibleMapped& mappedOf(const handles::Buffer& buffer)
+{
+    return static_cast<handles::Memory::HostVisibleMapped&>(*buffer.memory().lock()->mapped);
+}
+
+Readback::Readback(ReadbackRing& ring, VkDeviceSize size)
+    : m_ring(ring)
+    , m_size(size)
+    , m_ready(false)
+{}
+
+bool Readback::isReady() const
+{
+    if (!m_ready) m_ring.poll();
+
+    return m_ready;
+}
+
+std::span<const std::byte> Readback::data() const
+{
+    if (!isReady()) return {};
+
+    return m_data;
+}
+
+ReadbackRing::ReadbackRing(const handles::Device& device, VkDeviceSize size)
+    : m_device(device)
+    , m_size(size)
+    , m_memoryProperties(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+    , m_head(0)
+    , m_tail(0)
+{
+    //  the host reads every byte of the ring, so cached memory is much faster if there is one
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(device.physicalDevice(), &memoryProperties);
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i)
+    {
+        constexpr VkMemoryPropertyFlags cached =
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        if ((memoryProperties.memoryTypes[i].propertyFlags & cached) == cached)
+        {
+            m_memoryProperties = cached;
+            break;
+        }
+    }
+
+    m_buffer = createBuffer(size);
+}
+
+ReadbackRing::~ReadbackRing()
+{
+    m_entries.clear();
+    m_buffer.reset();
+}
+
+void ReadbackRing::record(const handles::CommandBuffer& commandBuffer,
+    VkFence fence,
+    VkBuffer src,
+    VkDeviceSize srcOffset,
+    std::shared_ptr<Readback> readback)
+{
+    const VkDeviceSize size = readback->size();
+
+    Entry entry{
+        .offset = m_head,
+        .end = m_head,
+        .fence = fence,
+        .readback = readback,
+        .done = false,
+    };
+
+    VkBuffer dst;
+    VkDeviceSize dstOffset = 0;
+    if (const auto offset = allocate(size); offset.has_value())
+    {
+        entry.offset = dstOffset = offset.value();
+        entry.end = m_head;
+        dst = *m_buffer;
+    }
+    else
+    {
+        //  keeps the ring position, so the entries still describe the used range in order
+        entry.dedicated = createBuffer(size);
+        dst = *entry.dedicated;
+    }
+
+    const VkMemoryBarrier before{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+    };
+    commandBuffer.pipelineBarrier(
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, {}, std::span{ &before, 1 });
+
+    const VkBufferCopy region{ .srcOffset = srcOffset, .dstOffset = dstOffset, .size = size };
+    commandBuffer.copyBuffer(src, dst, { &region, 1 });
+
+    const VkMemoryBarrier after{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+    };
+    commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+        {}, std::span{ &after, 1 });
+
+    m_entries.push_back(std::move(entry));
+}
+
+void ReadbackRing::release(VkFence fence)
+{
+    for (auto& entry : m_entries)
+    {
+        if (!entry.done && entry.fence == fence) resolve(entry);
+    }
+
+    collect();
+}
+
+void ReadbackRing::poll()
+{
+    for (auto& entry : m_entries)
+    {
+        //  fences are reset before anything is recorded with them, so signaled means complete
+        if (!entry.done && vkGetFenceStatus(m_device, entry.fence) == VK_SUCCESS) resolve(entry);
+    }
+
+    collect();
+}
+
+std::optional<VkDeviceSize> ReadbackRing::allocate(VkDeviceSize size)
+{
+    if (size >= m_size) return std::nullopt;
+
+    VkDeviceSize offset = alignUp(m_head, s_alignment);
+    if (m_head >= m_tail)
+    {
+        if (offset + size > m_size)
+        {
+            if (size >= m_tail) return std::nullopt;
+            offset = 0;
+        }
+    }
+    else if (offset + size >= m_tail)
+    {
+        return std::nullopt;
+    }
+
+    m_head = offset + size;
+
+    return offset;
+}
+
+std::unique_ptr<handles::Buffer> ReadbackRing::createBuffer(VkDeviceSize size) const
+{
+    auto buffer = std::make_unique<handles::Buffer>(m_device,
+        handles::BufferCreateInfo{}
+            .size(size)
+            .usage(VK_BUFFER_USAGE_TRANSFER_DST_BIT)
+            .sharingMode(VK_SHARING_MODE_EXCLUSIVE));
+    buffer->allocateAndBindMemory(m_memoryProperties).lock()->map();
+
+    return buffer;
+}
+
+void ReadbackRing::resolve(Entry& entry)
+{
+    if (auto readback = entry.readback.lock())
+    {
+        auto& mapped = mappedOf(entry.dedicated ? *entry.dedicated : *m_buffer);
+        const VkDeviceSize offset = entry.dedicated ? 0 : entry.offset;
+        mapped.invalidate(readback->size(), offset);
+
+        readback->m_data.resize(readback->size());
+        std::memcpy(readback->m_data.data(), mapped.read(readback->size(), offset),
+            readback->size());
+        readback->m_ready = true;
+    }
+
+    entry.dedicated.reset();
+    entry.done = true;
+}
+
+void ReadbackRing::collect()
+{
+    while (!m_entries.empty() && m_entries.front().done)
+    {
+        m_entries.pop_front();
+    }
+
+    if (m_entries.empty())
+    {
+        m_head = m_tail = 0;
+    }
+    else
+    {
+        m_tail = m_entries.front().offset;
+    }
+}
+
+}    //  namespace renderer::vk
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "ifenced_resource.hpp"
+
+#include <istorage_buffer.hpp>
+
+#include <vulkan/vulkan_core.h>
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class Buffer;
+class CommandBuffer;
+class Device;
+}
+
+class ReadbackRing;
+
+class Readback : public IReadback
+{
+    friend class ReadbackRing;
+
+public:
+    Readback(ReadbackRing& ring, VkDeviceSize size);
+
+    virtual bool isReady() const override;
+    virtual std::span<const std::byte> data() const override;
+
+    VkDeviceSize size() const { return m_size; }
+
+private:
+    ReadbackRing& m_ring;
+    const VkDeviceSize m_size;
+
+    bool m_ready;
+    std::vector<std::byte> m_data;
+};
+
+//  Persistently mapped host cached buffer the device local data is copied into. Copies are
+//  recorded right into the command buffer of the producer and resolved once its fence is signaled,
+//  so reading results back never waits for the device to become idle
+class ReadbackRing : public IFencedResource
+{
+public:
+    static constexpr VkDeviceSize s_defaultSize = 8 * 1024 * 1024;
+    static constexpr VkDeviceSize s_alignment = 16;
+
+public:
+    ReadbackRing(const handles::Device& device, VkDeviceSize size = s_defaultSize);
+    ReadbackRing(const ReadbackRing& other) = delete;
+    ~ReadbackRing();
+
+    //  copies the range after shader and transfer writes recorded into the command buffer before
+    void record(const handles::CommandBuffer& commandBuffer,
+        VkFence fence,
+        VkBuffer src,
+        VkDeviceSize srcOffset,
+        std::shared_ptr<Readback> readback);
+
+    //  the fence has been waited for, so every readback recorded with it can be resolved
+    virtual void release(VkFence fence) override;
+    void poll();
+
+private:
+    struct Entry
+    {
+        VkDeviceSize offset;
+        VkDeviceSize end;
+        VkFence fence;
+        std::weak_ptr<Readback> readback;
+        //  the readback didn't fit into the ring
+        std::unique_ptr<handles::Buffer> dedicated;
+        bool done;
+    };
+
+    std::optional<VkDeviceSize> allocate(VkDeviceSize size);
+    std::unique_ptr<handles::Buffer> createBuffer(VkDeviceSize size) const;
+    void resolve(Entry& entry);
+    void collect();
+
+private:
+    const handles::Device& m_device;
+    const VkDeviceSize m_size;
+    VkMemoryPropertyFlags m_memoryProperties;
+
+    std::unique_ptr<handles::Buffer> m_buffer;
+
+    VkDeviceSize m_head;
+    VkDeviceSize m_tail;
+
+    std::deque<Entry> m_entries;
+};
+
+}    //  namespace renderer::vk
@@ -27,6 +27,16 @@ Renderer::Renderer(const GraphicsContext& context, IRenderer::CreateInfo createI
 {}
 
 renderer::OperationContext Renderer::start(IRenderTarget& target)
+{
+    return begin(target, VK_SUBPASS_CONTENTS_INLINE);
+}
+
+renderer::OperationContext Renderer::startParallel(IRenderTarget& target)
+{
+    return begin(target, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+}
+
+renderer::OperationContext Renderer::begin(IRenderTarget& target, VkSubpassContents contents)
 {
     renderer::OperationContext result;
     result.emplace<vk::OperationContext>(this);
@@ -54,7 +64,8 @@ renderer::OperationContext Renderer::start(IRenderTarget& target)
             .clearValueCount(clearValues.size())
             .pClearValues(clearValues.data());
 
-    vkCmdBeginRenderPass(*kek.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(*kek.commandBuffer, &renderPassInfo, contents);
+    kek.secondaryContents = contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
 
     return result;
 }
@@ -85,7 +96,9 @@ IRenderer& Renderer::addRenderTarget(IRenderTarget& target)
             .format(renderInfo.imageFormat)
             .samples(m_multisampling)
             .loadOp(VK_ATTACHMENT_LOAD_OP_CLEAR)
-            .storeOp(VK_ATTACHMENT_STORE_OP_STORE)
+            //  the multisampled image is resolved within the subpass, it is never read afterwards
+            .storeOp(m_multisampling == VK_SAMPLE_COUNT_1_BIT ? VK_ATTACHMENT_STORE_OP_STORE :
+                                                                VK_ATTACHMENT_STORE_OP_DONT_CARE)
             .stencilLoadOp(VK_ATTACHMENT_LOAD_OP_DONT_CARE)
             .stencilStoreOp(VK_ATTACHMENT_STORE_OP_DONT_CARE)
             .initialLayout(VK_IMAGE_LAYOUT_UNDEFINED)
@@ -19,12 +19,14 @@ class Renderer : public IRenderer
 public:
     Renderer(const GraphicsContext& context, IRenderer::CreateInfo createInfo);
     virtual renderer::OperationContext start(IRenderTarget& target) override;
+    virtual renderer::OperationContext startParallel(IRenderTarget& target) override;
     virtual void finish(renderer::OperationContext& context) override;
 
     const handles::Device& device() const;
     VkSampleCountFlagBits sampleCount() const;
 
 private:
+    renderer::OperationContext begin(IRenderTarget& target, VkSubpassContents contents);
     IRenderer& addRenderTarget(IRenderTarget& target);
     handles::RenderPass& renderPass(IRenderTarget& target);
 
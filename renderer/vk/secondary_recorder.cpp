@@ -0,0 +1,197 @@
+#include "secondary_recorder.hpp"
+
+#include "handles/command_buffer.hpp"
+#include "handles/command_pool.hpp"
+#include "handles/device.hpp"
+
+#include <algorithm>
+
+namespace renderer::vk {
+
+namespace {
+
+//  set while a record task runs, on workers and on the thread calling run alike
+thread_local bool s_recordingTask = false;
+
+}    //  namespace
+
+SecondaryRecorder::SecondaryRecorder(const handles::Device& device)
+    : m_device(device)
+{}
+
+SecondaryRecorder::~SecondaryRecorder()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    //  buffers go back to their pools before the pools are destroyed
+    m_segments.clear();
+    m_slots.clear();
+}
+
+std::vector<VkCommandBuffer> SecondaryRecorder::run(uint32_t taskCount,
+    const RecordFunction& record)
+{
+    std::vector<VkCommandBuffer> result(taskCount, VK_NULL_HANDLE);
+    if (!taskCount) return result;
+
+    if (m_slots.empty()) start();
+
+    {
+        std::lock_guard lock(m_mutex);
+        DASSERT(!m_record, "secondary recording is not reentrant");
+
+        m_record = &record;
+        m_results = &result;
+        m_taskCount = taskCount;
+        m_nextTask = 0;
+        m_finishedTasks = 0;
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(m_slots.size() - 1);
+
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_finishedTasks == m_taskCount; });
+    m_record = nullptr;
+    m_results = nullptr;
+
+    return result;
+}
+
+std::unique_ptr<handles::CommandBuffer> SecondaryRecorder::acquireCached()
+{
+    //  the slot of the calling thread is used, workers have slots of their own
+    DASSERT(!s_recordingTask, "cached buffers are not to be acquired from record tasks");
+
+    if (m_slots.empty()) start();
+
+    acquire(m_slots.back());
+
+    auto result = std::move(m_slots.back().used.back());
+    m_slots.back().used.pop_back();
+
+    return result;
+}
+
+void SecondaryRecorder::retire(std::unique_ptr<handles::CommandBuffer> commandBuffer)
+{
+    DASSERT(!m_slots.empty(), "buffer was not acquired from this recorder");
+    DASSERT(!s_recordingTask, "cached buffers are not to be retired from record tasks");
+
+    m_slots.back().used.push_back(std::move(commandBuffer));
+}
+
+void SecondaryRecorder::record(VkFence fence)
+{
+    SlotBuffers buffers(m_slots.size());
+
+    bool empty = true;
+    for (size_t i = 0; i < m_slots.size(); ++i)
+    {
+        empty &= m_slots[i].used.empty();
+        buffers[i] = std::move(m_slots[i].used);
+        m_slots[i].used.clear();
+    }
+
+    if (empty) return;
+
+    m_segments.push(fence, std::move(buffers));
+}
+
+void SecondaryRecorder::release(VkFence fence)
+{
+    m_segments.release(fence, [&](SlotBuffers& buffers) {
+        //  begin resets them implicitly, their pools are created resettable
+        for (size_t i = 0; i < buffers.size(); ++i)
+        {
+            std::move(buffers[i].begin(), buffers[i].end(), std::back_inserter(m_slots[i].free));
+        }
+    });
+}
+
+void SecondaryRecorder::start()
+{
+    const uint32_t workerCount = (std::max)(std::thread::hardware_concurrency(), 2u) - 1;
+
+    m_slots.resize(workerCount + 1);
+    for (auto& slot : m_slots)
+    {
+        slot.pool = std::make_unique<handles::CommandPool>(m_device,
+            handles::CommandPoolCreateInfo{}
+                .queueFamilyIndex(m_device.queueFamilies()[handles::GRAPHICS_COMPUTE])
+                .flags(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT));
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&SecondaryRecorder::work, this, i);
+    }
+}
+
+void SecondaryRecorder::work(uint32_t slot)
+{
+    uint64_t generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stop || m_generation != generation; });
+            if (m_stop) return;
+
+            generation = m_generation;
+        }
+
+        drain(slot);
+    }
+}
+
+void SecondaryRecorder::drain(uint32_t slot)
+{
+    for (;;)
+    {
+        uint32_t task;
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_nextTask == m_taskCount) return;
+
+            task = m_nextTask++;
+        }
+
+        //  the run waits for every task, so the function outlives the unlocked call
+        auto& commandBuffer = acquire(m_slots[slot]);
+        s_recordingTask = true;
+        (*m_record)(task, commandBuffer);
+        s_recordingTask = false;
+
+        std::lock_guard lock(m_mutex);
+        (*m_results)[task] = commandBuffer;
+        if (++m_finishedTasks == m_taskCount) m_done.notify_one();
+    }
+}
+
+handles::CommandBuffer& SecondaryRecorder::acquire(Slot& slot)
+{
+    if (slot.free.empty())
+    {
+        slot.free.push_back(std::make_unique<handles::CommandBuffer>(m_device, *slot.pool,
+            VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+    }
+
+    slot.used.push_back(std::move(slot.free.back()));
+    slot.free.pop_back();
+
+    return *slot.used.back();
+}
+
+}    //  namespace renderer::vk
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "fence_segments.hpp"
+#include "ifenced_resource.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class CommandBuffer;
+class CommandPool;
+class Device;
+}
+
+//  Records secondary command buffers on worker threads. Command pools are externally synchronized,
+//  so every worker and the calling thread own a pool of their own and never share it. Recorded
+//  buffers are handed to the fence of the submission executing them and reused once it has been
+//  waited for. The workers are started on first use
+class SecondaryRecorder : public IFencedResource
+{
+public:
+    using RecordFunction = std::function<void(uint32_t task, handles::CommandBuffer&)>;
+
+public:
+    SecondaryRecorder(const handles::Device& device);
+    SecondaryRecorder(const SecondaryRecorder& other) = delete;
+    ~SecondaryRecorder();
+
+    //  runs record for every task and returns after all of them are done, the buffers are in task
+    //  order and have to be executed by the submission passed to the next record(fence)
+    std::vector<VkCommandBuffer> run(uint32_t taskCount, const RecordFunction& record);
+
+    //  a buffer of the calling thread's pool owned by the caller, it is handed to no fence until it
+    //  is retired. Not to be called from record tasks
+    std::unique_ptr<handles::CommandBuffer> acquireCached();
+    //  takes the buffer back, it is reused once the next submission has been waited for
+    void retire(std::unique_ptr<handles::CommandBuffer> commandBuffer);
+
+    //  hands the buffers recorded since the last call to the fence of the submission
+    virtual void record(VkFence fence) override;
+    virtual void release(VkFence fence) override;
+
+    //  the buffers are executed inside render passes
+    virtual bool renderPassOnly() const override { return true; }
+
+private:
+    struct Slot
+    {
+        std::unique_ptr<handles::CommandPool> pool;
+        std::vector<std::unique_ptr<handles::CommandBuffer>> free;
+        std::vector<std::unique_ptr<handles::CommandBuffer>> used;
+    };
+
+    //  indexed like m_slots
+    using SlotBuffers = std::vector<std::vector<std::unique_ptr<handles::CommandBuffer>>>;
+
+    void start();
+    void work(uint32_t slot);
+    //  takes tasks of the current run until none are left
+    void drain(uint32_t slot);
+    handles::CommandBuffer& acquire(Slot& slot);
+
+private:
+    const handles::Device& m_device;
+
+    //  the last slot belongs to the thread calling run
+    std::vector<Slot> m_slots;
+    std::vector<std::thread> m_workers;
+    FenceSegments<SlotBuffers> m_segments;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_stop = false;
+    uint64_t m_generation = 0;
+
+    //  state of the current run, written under m_mutex before the workers are woken
+    const RecordFunction* m_record = nullptr;
+    std::vector<VkCommandBuffer>* m_results = nullptr;
+    uint32_t m_taskCount = 0;
+    uint32_t m_nextTask = 0;
+    uint32_t m_finishedTasks = 0;
+};
+
+}    //  namespace renderer::vk
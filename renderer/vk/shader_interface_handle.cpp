@@ -1,13 +1,32 @@
 #include "shader_interface_handle.hpp"
 
+#include "uniform_arena.hpp"
+
 #include "handles/memory.hpp"
 
 #include <operation_context.hpp>
 
+#include <cstring>
+
 namespace renderer::vk {
 
 ShaderInterfaceHandle::ShaderInterfaceHandle(ShaderResource& uniformAllocator)
-    : m_uniformAllocator(uniformAllocator)
+    : m_uniformAllocator(&uniformAllocator)
+{
+    assureDescriptorCount(1);
+    m_currentDescriptor = m_descriptors.begin();
+}
+
+ShaderInterfaceHandle::ShaderInterfaceHandle(uint32_t pushConstantSize)
+    : m_hostData(pushConstantSize)
+{}
+
+ShaderInterfaceHandle::ShaderInterfaceHandle(
+    ShaderResource& persistent, UniformArena& arena, uint32_t size)
+    : m_uniformAllocator(&persistent)
+    , m_hostData(size)
+    , m_arena(&arena)
+    , m_arenaDescriptor(arena.fetchDescriptor())
 {
     assureDescriptorCount(1);
     m_currentDescriptor = m_descriptors.begin();
@@ -17,7 +36,22 @@ ShaderInterfaceHandle::~ShaderInterfaceHandle() {}
 
 void ShaderInterfaceHandle::write(const void* src, size_t size)
 {
-    if (!currentDescriptor()->memory.expired())
+    if (!m_uniformAllocator || m_arena)
+    {
+        DASSERT(size <= m_hostData.size(), "shader interface block overflow");
+        std::memcpy(m_hostData.data(), src, size);
+    }
+
+    if (!m_uniformAllocator) return;
+
+    if (m_arena)
+    {
+        //  draws recorded before keep their slice, this one is read by the following draws only
+        m_persistentValid = false;
+        m_lastWriteEpoch = m_arena->epoch();
+        pushSlice();
+    }
+    else if (!currentDescriptor()->memory.expired())
     {
         nextDescriptor();
         currentDescriptor()->memory.lock()->mapped->writeAndSync(src, size,
@@ -27,6 +61,11 @@ void ShaderInterfaceHandle::write(const void* src, size_t size)
 
 const void* ShaderInterfaceHandle::read(size_t size) const
 {
+    if (!m_uniformAllocator || m_arena)
+    {
+        return m_hostData.data();
+    }
+
     if (!currentDescriptor()->memory.expired())
     {
         return currentDescriptor()->memory.lock()->mapped->read(size,
@@ -36,20 +75,56 @@ const void* ShaderInterfaceHandle::read(size_t size) const
     return nullptr;
 }
 
+void ShaderInterfaceHandle::prepare(uint32_t framesInFlight)
+{
+    if (!m_arena)
+    {
+        assureDescriptorCount(framesInFlight);
+        return;
+    }
+
+    if (m_sliceEpoch == m_arena->epoch())
+    {
+        m_useArena = true;
+    }
+    else if (m_persistentValid || m_lastWriteEpoch <= m_arena->completedEpoch())
+    {
+        //  nothing in flight reads the persistent slot since the last write
+        if (!m_persistentValid)
+        {
+            (*m_currentDescriptor)
+                ->memory.lock()
+                ->mapped->writeAndSync(m_hostData.data(), m_hostData.size(),
+                    (*m_currentDescriptor)->offset());
+            m_persistentValid = true;
+        }
+        m_useArena = false;
+    }
+    else
+    {
+        pushSlice();
+        m_useArena = true;
+    }
+
+    if (m_useArena) m_arena->countUse();
+}
+
 void ShaderInterfaceHandle::assureDescriptorCount(uint32_t requiredCount)
 {
+    DASSERT(m_uniformAllocator, "push constants have no descriptors");
+
     while (m_descriptors.size() < requiredCount)
-        m_descriptors.emplace_back(m_uniformAllocator.fetchDescriptor());
+        m_descriptors.emplace_back(m_uniformAllocator->fetchDescriptor());
 }
 
-std::shared_ptr<ShaderResource::Descriptor> ShaderInterfaceHandle::currentDescriptor()
+const std::shared_ptr<ShaderResource::Descriptor>& ShaderInterfaceHandle::currentDescriptor()
 {
-    return *m_currentDescriptor;
+    return m_useArena ? m_arenaDescriptor : *m_currentDescriptor;
 }
 
-const std::shared_ptr<ShaderResource::Descriptor> ShaderInterfaceHandle::currentDescriptor() const
+const std::shared_ptr<ShaderResource::Descriptor>& ShaderInterfaceHandle::currentDescriptor() const
 {
-    return *m_currentDescriptor;
+    return m_useArena ? m_arenaDescriptor : *m_currentDescriptor;
 }
 
 void ShaderInterfaceHandle::nextDescriptor()
@@ -57,9 +132,28 @@ void ShaderInterfaceHandle::nextDescriptor()
     if (++m_currentDescriptor == m_descriptors.end()) m_currentDescriptor = m_descriptors.begin();
 }
 
+void ShaderInterfaceHandle::pushSlice()
+{
+    const auto slice = m_arena->push(m_hostData.data(), m_hostData.size());
+    m_arena->populateDescriptor(*m_arenaDescriptor, slice, m_hostData.size());
+    m_sliceEpoch = m_arena->epoch();
+}
+
 std::shared_ptr<ShaderInterfaceHandle> ShaderInterfaceHandle::create(ShaderResource& allocator)
 {
     return std::shared_ptr<ShaderInterfaceHandle>{ new ShaderInterfaceHandle(allocator) };
 }
 
+std::shared_ptr<ShaderInterfaceHandle> ShaderInterfaceHandle::createPushConstant(uint32_t size)
+{
+    return std::shared_ptr<ShaderInterfaceHandle>{ new ShaderInterfaceHandle(size) };
+}
+
+std::shared_ptr<ShaderInterfaceHandle> ShaderInterfaceHandle::createArena(
+    ShaderResource& persistent, UniformArena& arena, uint32_t size)
+{
+    return std::shared_ptr<ShaderInterfaceHandle>{ new ShaderInterfaceHandle(
+        persistent, arena, size) };
+}
+
 }    //  namespace renderer::vk
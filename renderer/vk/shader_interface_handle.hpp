@@ -8,6 +8,8 @@
 
 #include <list>
 #include <memory>
+#include <span>
+#include <vector>
 
 namespace renderer::vk {
 
@@ -15,12 +17,16 @@ namespace handles {
 class Memory;
 }
 
+class UniformArena;
+
 class ShaderInterfaceHandle
     : public IShaderInterfaceHandle
     , public std::enable_shared_from_this<ShaderInterfaceHandle>
 {
 private:
     ShaderInterfaceHandle(ShaderResource&);
+    ShaderInterfaceHandle(uint32_t pushConstantSize);
+    ShaderInterfaceHandle(ShaderResource& persistent, UniformArena& arena, uint32_t size);
 
 public:
     struct TypeVisitor : public ShaderInterfaceHandleVisitor
@@ -28,6 +34,7 @@ public:
         void visit(ShaderInterfaceHandle& handle) override { this->handle = &handle; }
 
         ShaderInterfaceHandle* operator->() { return handle; }
+        ShaderInterfaceHandle& operator*() { return *handle; }
 
     private:
         ShaderInterfaceHandle* handle = nullptr;
@@ -35,6 +42,13 @@ public:
 
 public:
     [[nodiscard]] static std::shared_ptr<ShaderInterfaceHandle> create(ShaderResource&);
+    //  host side block recorded with vkCmdPushConstants, owns no descriptors
+    [[nodiscard]] static std::shared_ptr<ShaderInterfaceHandle> createPushConstant(
+        uint32_t size);
+    //  writes go to the arena of the current submission, the data moves to a single persistent
+    //  slot once no submission in flight refers to it
+    [[nodiscard]] static std::shared_ptr<ShaderInterfaceHandle> createArena(
+        ShaderResource& persistent, UniformArena& arena, uint32_t size);
     ~ShaderInterfaceHandle();
 
     virtual void accept(ShaderInterfaceHandleVisitor& visitor) override { visitor.visit(*this); }
@@ -47,15 +61,30 @@ public:
     virtual void write(const void* src, size_t size) override;
     virtual const void* read(size_t size) const override;
 
+    //  makes currentDescriptor() valid for the submission being recorded
+    void prepare(uint32_t framesInFlight);
     void assureDescriptorCount(uint32_t requiredCount);
-    std::shared_ptr<ShaderResource::Descriptor> currentDescriptor();
-    const std::shared_ptr<ShaderResource::Descriptor> currentDescriptor() const;
+    const std::shared_ptr<ShaderResource::Descriptor>& currentDescriptor();
+    const std::shared_ptr<ShaderResource::Descriptor>& currentDescriptor() const;
+
+    std::span<const std::byte> pushConstants() const { return m_hostData; }
 
 private:
     void nextDescriptor();
+    void pushSlice();
 
 private:
-    ShaderResource& m_uniformAllocator;
+    ShaderResource* m_uniformAllocator = nullptr;
+    //  push constant block, or the last write of arena handles
+    std::vector<std::byte> m_hostData;
+
+    UniformArena* m_arena = nullptr;
+    std::shared_ptr<ShaderResource::Descriptor> m_arenaDescriptor;
+    uint64_t m_sliceEpoch = 0;
+    uint64_t m_lastWriteEpoch = 0;
+    bool m_persistentValid = false;
+    bool m_useArena = false;
+
     std::list<std::shared_ptr<ShaderResource::Descriptor>> m_descriptors;
     std::list<std::shared_ptr<ShaderResource::Descriptor>>::const_iterator m_currentDescriptor;
 };
@@ -0,0 +1,224 @@
+#include "staging_ring.hpp"
+
+#include "handles/buffer.hpp"
+#include "handles/command.hpp"
+#include "handles/device.hpp"
+#include "handles/memory.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace renderer::vk {
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool overlaps(const VkBufferCopy& lhs, const VkBufferCopy& rhs)
+{
+    return lhs.dstOffset < rhs.dstOffset + rhs.size && rhs.dstOffset < lhs.dstOffset + lhs.size;
+}
+
+StagingRing::StagingRing(const handles::Device& device, VkDeviceSize size)
+    : m_device(device)
+    , m_size(size)
+    , m_head(0)
+    , m_tail(0)
+    , m_openBegin(0)
+{
+    m_buffer = std::make_unique<handles::Buffer>(device, handles::Buffer::staging().size(size));
+
+    auto mapped =
+        m_buffer
+            ->allocateAndBindMemory(
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+            .lock()
+            ->map()
+            .lock();
+    m_data = static_cast<char*>(
+        std::static_pointer_cast<handles::Memory::HostVisibleMapped>(mapped)->data);
+}
+
+StagingRing::~StagingRing()
+{
+    m_buffer.reset();
+}
+
+bool StagingRing::upload(const void* src, VkDeviceSize size, VkBuffer dst, VkDeviceSize dstOffset)
+{
+    if (!size) return true;
+
+    const auto offset = push(src, size, s_defaultAlignment);
+    if (!offset.has_value()) return false;
+
+    m_copies.push_back(Copy{
+        .dst = dst,
+        .region = VkBufferCopy{ .srcOffset = offset.value(), .dstOffset = dstOffset, .size = size },
+    });
+
+    return true;
+}
+
+bool StagingRing::upload(
+    const void* src, VkDeviceSize size, Command command, VkDeviceSize alignment)
+{
+    const auto offset = push(src, size, alignment);
+    if (!offset.has_value()) return false;
+
+    m_commands.emplace_back(std::move(command), offset.value());
+
+    return true;
+}
+
+bool StagingRing::record(const handles::CommandBuffer& commandBuffer, VkFence fence)
+{
+    if (m_copies.empty() && m_commands.empty()) return false;
+
+    commandBuffer.reset();
+    ASSERT(commandBuffer.begin(handles::CommandBufferBeginInfo{}.flags(
+               VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)) == VK_SUCCESS,
+        "failed to begin staging command buffer");
+    recordPending(commandBuffer);
+    ASSERT(commandBuffer.end() == VK_SUCCESS, "failed to record staging command buffer");
+
+    m_segments.push(fence, Span{ .end = m_head, .token = 0 });
+    m_openBegin = m_head;
+
+    return true;
+}
+
+void StagingRing::release(VkFence fence)
+{
+    m_segments.releaseInOrder(fence, [&](const Span& span) { m_tail = span.end; });
+}
+
+std::optional<VkDeviceSize> StagingRing::stage(
+    const void* src, VkDeviceSize size, VkDeviceSize alignment)
+{
+    DASSERT(m_copies.empty() && m_commands.empty(),
+        "a ring either records its copies or leaves them to the caller");
+
+    const auto offset = allocate(size, alignment);
+    if (offset.has_value()) std::memcpy(m_data + offset.value(), src, size);
+
+    return offset;
+}
+
+void StagingRing::close(uint64_t token)
+{
+    if (m_head == m_openBegin) return;
+
+    m_segments.push(VK_NULL_HANDLE, Span{ .end = m_head, .token = token });
+    m_openBegin = m_head;
+}
+
+void StagingRing::releaseUpTo(uint64_t completedToken)
+{
+    m_segments.releaseInOrderIf(
+        [&](const auto& segment) {
+            return segment.fence == VK_NULL_HANDLE && segment.payload.token <= completedToken;
+        },
+        [&](const Span& span) { m_tail = span.end; });
+}
+
+void StagingRing::flush()
+{
+    if (m_copies.empty() && m_commands.empty()) return;
+
+    {
+        auto oneTimeCommand = m_device.oneTimeCommand(handles::GRAPHICS_COMPUTE);
+        recordPending(oneTimeCommand());
+    }
+
+    //  the open segment is consumed already, so its space may be reused right away
+    m_head = m_openBegin;
+}
+
+std::optional<VkDeviceSize> StagingRing::push(
+    const void* src, VkDeviceSize size, VkDeviceSize alignment)
+{
+    auto offset = allocate(size, alignment);
+    if (!offset.has_value())
+    {
+        flush();
+        offset = allocate(size, alignment);
+    }
+
+    if (offset.has_value()) std::memcpy(m_data + offset.value(), src, size);
+
+    return offset;
+}
+
+std::optional<VkDeviceSize> StagingRing::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    if (size >= m_size) return std::nullopt;
+
+    //  m_head == m_tail means empty, so the head is never allowed to catch up with the tail
+    if (m_segments.empty() && m_head == m_openBegin)
+    {
+        m_head = m_tail = m_openBegin = 0;
+    }
+
+    VkDeviceSize offset = alignUp(m_head, alignment);
+    if (m_head >= m_tail)
+    {
+        if (offset + size > m_size)
+        {
+            if (size >= m_tail) return std::nullopt;
+            offset = 0;
+        }
+    }
+    else if (offset + size >= m_tail)
+    {
+        return std::nullopt;
+    }
+
+    m_head = offset + size;
+
+    return offset;
+}
+
+void StagingRing::recordPending(const handles::CommandBuffer& commandBuffer)
+{
+    constexpr VkPipelineStageFlags consumerStages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    //  previous submissions may still read the regions we are going to overwrite
+    commandBuffer.pipelineBarrier(consumerStages, VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+
+    std::vector<VkBufferCopy> regions;
+    for (size_t i = 0; i < m_copies.size(); ++i)
+    {
+        regions.push_back(m_copies[i].region);
+
+        const bool last = i + 1 == m_copies.size();
+        if (last || m_copies[i + 1].dst != m_copies[i].dst ||
+            std::any_of(regions.begin(), regions.end(),
+                [&](const auto& region) { return overlaps(region, m_copies[i + 1].region); }))
+        {
+            commandBuffer.copyBuffer(*m_buffer, m_copies[i].dst, regions);
+            regions.clear();
+        }
+    }
+
+    for (auto& [command, offset] : m_commands)
+    {
+        command(commandBuffer, *m_buffer, offset);
+    }
+
+    const VkMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+            VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+    };
+    commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, consumerStages, 0, {},
+        std::span{ &barrier, 1 });
+
+    m_copies.clear();
+    m_commands.clear();
+}
+
+}    //  namespace renderer::vk
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "fence_segments.hpp"
+#include "ifenced_resource.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class Buffer;
+class CommandBuffer;
+class Device;
+}
+
+//  Persistently mapped host visible buffer used as a source for device local uploads. Writes are
+//  bump allocated, the copies are recorded when the next submission is made and executed first in
+//  it, so the destinations are retired with the fence of the submission copying into them. The
+//  space is reclaimed once that fence has been waited for. Recorders of their own, like the upload
+//  manager, stage the data only and close the written space with a token instead
+class StagingRing : public IFencedResource
+{
+public:
+    using Command =
+        std::function<void(const handles::CommandBuffer&, VkBuffer staging, VkDeviceSize offset)>;
+
+    static constexpr VkDeviceSize s_defaultSize = 32 * 1024 * 1024;
+    static constexpr VkDeviceSize s_defaultAlignment = 16;
+
+public:
+    StagingRing(const handles::Device& device, VkDeviceSize size = s_defaultSize);
+    StagingRing(const StagingRing& other) = delete;
+    ~StagingRing();
+
+    //  both return false if the data doesn't fit, the caller has to upload it by itself then
+    bool upload(const void* src, VkDeviceSize size, VkBuffer dst, VkDeviceSize dstOffset);
+    bool upload(const void* src,
+        VkDeviceSize size,
+        Command command,
+        VkDeviceSize alignment = s_defaultAlignment);
+
+    //  records the pending copies into a command buffer of their own, which has to be submitted
+    //  ahead of the others in the batch signaling the fence. False if nothing is pending
+    bool record(const handles::CommandBuffer& commandBuffer, VkFence fence);
+    virtual void release(VkFence fence) override;
+
+    //  copies the data into the ring without recording anything, nothing if it doesn't fit. The
+    //  space is kept until the token of the close following the stage is released
+    std::optional<VkDeviceSize> stage(
+        const void* src, VkDeviceSize size, VkDeviceSize alignment = s_defaultAlignment);
+    void close(uint64_t token);
+    //  reclaims the space closed with any token up to completedToken
+    void releaseUpTo(uint64_t completedToken);
+
+    const handles::Buffer& buffer() const { return *m_buffer; }
+
+    //  records pending uploads into a one time command and waits for them
+    void flush();
+
+private:
+    //  closed with a fence or, if that is null, with a token
+    struct Span
+    {
+        VkDeviceSize end;
+        uint64_t token;
+    };
+
+    struct Copy
+    {
+        VkBuffer dst;
+        VkBufferCopy region;
+    };
+
+    std::optional<VkDeviceSize> push(const void* src, VkDeviceSize size, VkDeviceSize alignment);
+    std::optional<VkDeviceSize> allocate(VkDeviceSize size, VkDeviceSize alignment);
+    void recordPending(const handles::CommandBuffer& commandBuffer);
+
+private:
+    const handles::Device& m_device;
+    const VkDeviceSize m_size;
+
+    std::unique_ptr<handles::Buffer> m_buffer;
+    char* m_data;
+
+    VkDeviceSize m_head;
+    VkDeviceSize m_tail;
+    VkDeviceSize m_openBegin;
+
+    FenceSegments<Span> m_segments;
+    std::vector<Copy> m_copies;
+    std::vector<std::pair<Command, VkDeviceSize>> m_commands;
+};
+
+}    //  namespace renderer::vk
@@ -1,6 +1,7 @@
 #include "storage_buffer.hpp"
 
 #include "handles/buffer.hpp"
+#include "handles/command_buffer.hpp"
 #include "handles/command_pool.hpp"
 #include "handles/device.hpp"
 #include "handles/fence.hpp"
@@ -8,6 +9,10 @@
 #include "handles/queue.hpp"
 
 #include "compute_pipeline.hpp"
+#include "readback_ring.hpp"
+#include "transient_descriptor_allocator.hpp"
+#include "staging_ring.hpp"
+#include "upload_manager.hpp"
 
 namespace renderer::vk {
 
@@ -15,19 +20,35 @@ StorageBuffer::StorageBuffer(GraphicsContext& context, CreateInfo createInfo)
     : m_context(context)
     , m_emitWait(false)
     , m_elementCount(createInfo.initialDataSize)
+    , m_sizeInBytes(createInfo.initialDataSize * createInfo.dataTypeMetaInfo.typeSize)
     , m_commandBuffer(std::make_unique<handles::CommandBuffer>(
           context.device().commandPool(handles::GRAPHICS_COMPUTE).lock()->allocateBuffer()))
+    , m_stagingCommandBuffer(std::make_unique<handles::CommandBuffer>(
+          context.device().commandPool(handles::GRAPHICS_COMPUTE).lock()->allocateBuffer()))
 {
-    const size_t sizeInBytes = createInfo.initialDataSize * createInfo.dataTypeMetaInfo.typeSize;
-    m_handle = context.fetchHandleSpecific(ShaderBlockType::STORAGE, sizeInBytes);
+    m_handle = context.fetchHandleSpecific(ShaderBlockType::STORAGE, m_sizeInBytes);
 
-    m_handle->write(createInfo.initialData, sizeInBytes);
+    m_handle->write(createInfo.initialData, m_sizeInBytes);
 
     m_computeFinishedSemaphore =
         std::make_unique<handles::Semaphore>(context.device(), handles::SemaphoreCreateInfo{});
 
     m_computeInFlightFence = std::make_unique<handles::Fence>(context.device(),
         handles::FenceCreateInfo{}.flags(VK_FENCE_CREATE_SIGNALED_BIT));
+    m_transientDescriptorAllocator =
+        std::make_unique<TransientDescriptorAllocator>(context.device());
+}
+
+StorageBuffer::~StorageBuffer()
+{
+    //  the subsystems refer to the fence until it is released
+    vkWaitForFences(
+        m_context.device(), 1, m_computeInFlightFence->handlePtr(), VK_TRUE, UINT64_MAX);
+    m_context.device().releaseFence(*m_computeInFlightFence, *m_transientDescriptorAllocator);
+
+    //  draws of frames in flight may still read the elements, as instances or indirect commands,
+    //  so the slot isn't handed out again before they finish
+    m_context.device().retire([handle = std::move(m_handle)] {});
 }
 
 void StorageBuffer::accept(ComputerInfoVisitor& visitor) const
@@ -39,6 +60,7 @@ bool StorageBuffer::prepare(renderer::OperationContext& context)
 {
     vkWaitForFences(
         m_context.device(), 1, m_computeInFlightFence->handlePtr(), VK_TRUE, UINT64_MAX);
+    m_context.device().releaseFence(*m_computeInFlightFence, *m_transientDescriptorAllocator);
 
     vkResetFences(m_context.device(), 1, m_computeInFlightFence->handlePtr());
 
@@ -47,7 +69,11 @@ bool StorageBuffer::prepare(renderer::OperationContext& context)
     specContext.specificTarget = this;
 
     m_commandBuffer->reset();
-    return m_commandBuffer->begin() == VK_SUCCESS;
+    if (m_commandBuffer->begin() != VK_SUCCESS) return false;
+
+    m_uploadToken = m_context.device().uploadManager().acquire(*m_commandBuffer);
+
+    return true;
 }
 
 void StorageBuffer::present(renderer::OperationContext& context)
@@ -56,20 +82,54 @@ void StorageBuffer::present(renderer::OperationContext& context)
     auto [x, y, z] = specContext.computePipeline->computeDimensions();
 
     //  move element count to some more logically suitable place?
-    m_commandBuffer->dispatch(m_elementCount / x, y, z);
+    //  the last group is partial if the count isn't a multiple of the group size
+    m_commandBuffer->dispatch((m_elementCount + x - 1) / x, y, z);
+
+    const auto& bufferInfo = m_handle->currentDescriptor()->descriptorBufferInfo;
+    for (auto& readback : m_pendingReadbacks)
+    {
+        m_context.device().readbackRing().record(*m_commandBuffer, *m_computeInFlightFence,
+            bufferInfo.buffer(), bufferInfo.offset(), std::move(readback));
+    }
+    m_pendingReadbacks.clear();
 
     ASSERT(m_commandBuffer->end() == VK_SUCCESS, "failed to end command buffer");
 
-    auto submitInfo =
-        handles::SubmitInfo{}.commandBufferCount(1).pCommandBuffers(m_commandBuffer->handlePtr());
+    //  writes made up to now are copied ahead of the dispatch, in the batch retired with its fence
+    std::vector<VkCommandBuffer> commandBuffers{ m_commandBuffer->handle() };
+    if (m_context.device().stagingRing().record(*m_stagingCommandBuffer, *m_computeInFlightFence))
+    {
+        commandBuffers.insert(commandBuffers.begin(), m_stagingCommandBuffer->handle());
+    }
 
-    if (!m_computeWaitSemaphores.empty())
+    auto submitInfo = handles::SubmitInfo{}
+                          .commandBufferCount(commandBuffers.size())
+                          .pCommandBuffers(commandBuffers.data());
+
+    std::vector<VkSemaphore> waitSemaphores = std::move(m_computeWaitSemaphores);
+    m_computeWaitSemaphores.clear();
+    std::vector<VkPipelineStageFlags> waitStages(
+        waitSemaphores.size(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+    //  binary semaphores ignore their wait values, only the upload one is a timeline semaphore
+    std::vector<uint64_t> waitValues(waitSemaphores.size(), 0);
+    if (m_uploadToken.has_value())
     {
-        submitInfo.waitSemaphoreCount(m_computeWaitSemaphores.size())
-            .pWaitSemaphores(m_computeWaitSemaphores.data());
-        m_computeWaitSemaphores.clear();
+        waitSemaphores.push_back(m_context.device().uploadManager().semaphore());
+        waitStages.push_back(UploadManager::s_consumerStages);
+        waitValues.push_back(m_uploadToken.value());
+        m_uploadToken.reset();
     }
 
+    const auto timelineInfo = handles::TimelineSemaphoreSubmitInfo{}
+                                  .waitSemaphoreValueCount(waitValues.size())
+                                  .pWaitSemaphoreValues(waitValues.data());
+
+    submitInfo.pNext(&timelineInfo)
+        .waitSemaphoreCount(waitSemaphores.size())
+        .pWaitSemaphores(waitSemaphores.data())
+        .pWaitDstStageMask(waitStages.data());
+
     if (m_emitWait)
     {
         submitInfo.signalSemaphoreCount(1).pSignalSemaphores(
@@ -77,11 +137,15 @@ void StorageBuffer::present(renderer::OperationContext& context)
         m_emitWait = false;
     }
 
+    m_context.device().flushMappedMemory();
+
     ASSERT(m_context.device()
                 .queue(handles::GRAPHICS_COMPUTE)
                 .lock()
                 ->submit(1, &submitInfo, *m_computeInFlightFence) == VK_SUCCESS,
         "failed to submit compute command buffer!");
+    m_context.device().recordFence(
+        *m_computeInFlightFence, *m_transientDescriptorAllocator, false);
 }
 
 void StorageBuffer::bind(renderer::OperationContext& context) const
@@ -96,6 +160,74 @@ void StorageBuffer::draw(renderer::OperationContext& context) const
     get(context).commandBuffer->draw(m_elementCount, 1, 0, 0);
 }
 
+void StorageBuffer::clear(renderer::OperationContext& context)
+{
+    const auto& bufferInfo = m_handle->currentDescriptor()->descriptorBufferInfo;
+    auto& commandBuffer = *get(context).commandBuffer;
+
+    //  draws of previous submissions may still read the buffer as commands or instances
+    commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, 0);
+
+    commandBuffer.fillBuffer(bufferInfo.buffer(), bufferInfo.offset(), m_sizeInBytes, 0);
+
+    const VkMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+    };
+    commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, {}, std::span{ &barrier, 1 });
+}
+
+void StorageBuffer::bindInstances(renderer::OperationContext& context) const
+{
+    VkBuffer buf = m_handle->currentDescriptor()->descriptorBufferInfo.buffer();
+    VkDeviceSize offset = m_handle->currentDescriptor()->descriptorBufferInfo.offset();
+    get(context).commandBuffer->bindVertexBuffer(1, 1, &buf, &offset);
+}
+
+void StorageBuffer::drawIndexedIndirect(
+    renderer::OperationContext& context, const IStorageBuffer& drawCount) const
+{
+    static_assert(sizeof(DrawIndexedIndirectCommand) == sizeof(VkDrawIndexedIndirectCommand));
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+
+    const auto& device = m_context.device();
+    const auto& commands = m_handle->currentDescriptor()->descriptorBufferInfo;
+    auto& commandBuffer = *get(context).commandBuffer;
+
+    if (device.drawIndirectCountSupported())
+    {
+        const auto& count = static_cast<const StorageBuffer&>(drawCount)
+                                .m_handle->currentDescriptor()
+                                ->descriptorBufferInfo;
+        commandBuffer.drawIndexedIndirectCount(commands.buffer(), commands.offset(),
+            count.buffer(), count.offset(), m_elementCount, stride);
+        return;
+    }
+
+    //  commands past the count are zeroed by clear() and draw nothing
+    if (device.multiDrawIndirectSupported())
+    {
+        commandBuffer.drawIndexedIndirect(
+            commands.buffer(), commands.offset(), m_elementCount, stride);
+        return;
+    }
+
+    for (uint64_t i = 0; i < m_elementCount; ++i)
+    {
+        commandBuffer.drawIndexedIndirect(commands.buffer(), commands.offset() + i * stride, 1, 0);
+    }
+}
+
+void StorageBuffer::drawIndexedInstanced(
+    renderer::OperationContext& context, uint32_t indexCount) const
+{
+    get(context).commandBuffer->drawIndexed(indexCount, m_elementCount, 0, 0, 0);
+}
+
 std::weak_ptr<IShaderInterfaceHandle> StorageBuffer::handle() const
 {
     return m_handle;
@@ -119,4 +251,17 @@ uint32_t StorageBuffer::descriptorsRequired() const
     return 1;
 }
 
+TransientDescriptorAllocator& StorageBuffer::transientDescriptorAllocator()
+{
+    return *m_transientDescriptorAllocator;
+}
+
+std::shared_ptr<IReadback> StorageBuffer::read()
+{
+    auto readback = std::make_shared<Readback>(m_context.device().readbackRing(), m_sizeInBytes);
+    m_pendingReadbacks.push_back(readback);
+
+    return readback;
+}
+
 }    //  namespace renderer::vk
@@ -2,11 +2,17 @@
 
 #include "graphics_context.hpp"
 #include "ispecific_operation_target.hpp"
+#include "upload_manager.hpp"
 
 #include <istorage_buffer.hpp>
 
+#include <optional>
+
 namespace renderer::vk {
 
+class Readback;
+class TransientDescriptorAllocator;
+
 namespace handles {
 class Semaphore;
 class Fence;
@@ -16,6 +22,7 @@ class StorageBuffer : public SpecificOperationTarget<IStorageBuffer>
 {
 public:
     StorageBuffer(GraphicsContext& context, IStorageBuffer::CreateInfo createInfo);
+    ~StorageBuffer();
 
     virtual void accept(ComputerInfoVisitor& visitor) const override;
     virtual bool prepare(renderer::OperationContext& context) override;
@@ -23,24 +30,40 @@ public:
 
     virtual void bind(renderer::OperationContext& context) const override;
     virtual void draw(renderer::OperationContext& context) const override;
+    virtual void clear(renderer::OperationContext& context) override;
+    virtual void bindInstances(renderer::OperationContext& context) const override;
+    virtual void drawIndexedIndirect(
+        renderer::OperationContext& context, const IStorageBuffer& drawCount) const override;
+    virtual void drawIndexedInstanced(
+        renderer::OperationContext& context, uint32_t indexCount) const override;
     virtual std::weak_ptr<IShaderInterfaceHandle> handle() const override;
 
     virtual void waitFor(OperationContext& context) override;
     virtual void populateWaitInfo(OperationContext& context) override;
     virtual uint32_t descriptorsRequired() const override;
+    virtual TransientDescriptorAllocator& transientDescriptorAllocator() override;
+
+    virtual std::shared_ptr<IReadback> read() override;
 
 private:
     const GraphicsContext& m_context;
 
     bool m_emitWait;
     uint64_t m_elementCount;
+    size_t m_sizeInBytes;
 
     std::vector<VkSemaphore> m_computeWaitSemaphores;
+    std::optional<UploadManager::Token> m_uploadToken;
 
     std::unique_ptr<handles::CommandBuffer> m_commandBuffer;
+    std::unique_ptr<handles::CommandBuffer> m_stagingCommandBuffer;
     std::unique_ptr<handles::Fence> m_computeInFlightFence;
     std::unique_ptr<handles::Semaphore> m_computeFinishedSemaphore;
+    std::unique_ptr<TransientDescriptorAllocator> m_transientDescriptorAllocator;
     std::shared_ptr<ShaderInterfaceHandle> m_handle;
+
+    //  recorded after the next dispatch
+    std::vector<std::shared_ptr<Readback>> m_pendingReadbacks;
 };
 
 }    //  namespace renderer::vk
@@ -1,6 +1,8 @@
 #include "swapchain.hpp"
 
 #include "graphics_context.hpp"
+#include "staging_ring.hpp"
+#include "transient_descriptor_allocator.hpp"
 
 #include "handles/command_pool.hpp"
 #include "handles/queue.hpp"
@@ -14,6 +16,33 @@
 
 namespace renderer::vk {
 
+//  the contents neither come from nor outlive the render pass, so the attachment may never be
+//  backed by memory at all on tile based gpus
+static bool isTransient(const AttachmentDescription& attachment)
+{
+    return attachment.loadOp() != VK_ATTACHMENT_LOAD_OP_LOAD &&
+        attachment.stencilLoadOp() != VK_ATTACHMENT_LOAD_OP_LOAD &&
+        attachment.storeOp() == VK_ATTACHMENT_STORE_OP_DONT_CARE &&
+        attachment.stencilStoreOp() == VK_ATTACHMENT_STORE_OP_DONT_CARE;
+}
+
+static VkImageUsageFlags transientUsage(const AttachmentDescription& attachment)
+{
+    return isTransient(attachment) ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT : 0;
+}
+
+static void allocateAttachmentMemory(handles::Image& image, const AttachmentDescription& attachment)
+{
+    if (isTransient(attachment))
+    {
+        image.allocateAndBindTransientMemory();
+    }
+    else
+    {
+        image.allocateAndBindMemory(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+}
+
 VkExtent2D Swapchain::chooseExtent(const VkSurfaceCapabilitiesKHR& capabilities,
     const IVulkanSurface& window)
 {
@@ -106,8 +135,6 @@ Swapchain::Swapchain(
     m_maxFramesInFlight = m_swapchainInfo.framesInFlight;
     m_surface.registerFramebufferResizeCallback([this](int, int) { m_needRecreate = true; });
 
-    m_resourcesInUse.resize(m_maxFramesInFlight);
-
     constexpr handles::FenceCreateInfo fenceInfo =
         handles::FenceCreateInfo{}.flags(VK_FENCE_CREATE_SIGNALED_BIT);
 
@@ -119,11 +146,19 @@ Swapchain::Swapchain(
         m_renderFinishedSemaphores.emplaceBack(m_context.device(), handles::SemaphoreCreateInfo{});
     }
 
+    m_transientDescriptorAllocator =
+        std::make_unique<TransientDescriptorAllocator>(m_context.device());
+
     m_commandBuffers =
         m_context.device()
             .commandPool(handles::GRAPHICS_COMPUTE)
             .lock()
             ->allocateBuffers(m_maxFramesInFlight);
+    m_stagingCommandBuffers =
+        m_context.device()
+            .commandPool(handles::GRAPHICS_COMPUTE)
+            .lock()
+            ->allocateBuffers(m_maxFramesInFlight);
 
     const auto supportDetails =
         Swapchain::supportDetails(m_context.device().physicalDevice(), m_surface.surfaceKHR());
@@ -176,6 +211,10 @@ Swapchain::~Swapchain()
 
     destroy();
 
+    for (size_t i = 0; i < m_inFlightFences.size(); ++i)
+    {
+        m_context.device().releaseFence(m_inFlightFences[i], *m_transientDescriptorAllocator);
+    }
     m_inFlightFences.clear();
     m_imageAvailableSemaphores.clear();
     m_renderFinishedSemaphores.clear();
@@ -207,9 +246,10 @@ void Swapchain::populateOperationContext(OperationContext& context)
                         m_depthImage = std::make_unique<handles::Image>(m_context.device(),
                             imageCreateInfo()
                                 .format(m_depthFormat)
-                                .usage(VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
+                                .usage(transientUsage(attachment) |
+                                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
                                 .samples(attachment.samples()));
-                        m_depthImage->allocateAndBindMemory(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                        allocateAttachmentMemory(*m_depthImage, attachment);
 
                         auto depthViewInfo =
                             imageViewCreateInfo().image(*m_depthImage).format(m_depthFormat);
@@ -226,10 +266,10 @@ void Swapchain::populateOperationContext(OperationContext& context)
                         m_colorImage = std::make_unique<handles::Image>(m_context.device(),
                             imageCreateInfo()
                                 .format(m_swapchain->imageFormat())
-                                .usage(VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
+                                .usage(transientUsage(attachment) |
                                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
                                 .samples(attachment.samples()));
-                        m_colorImage->allocateAndBindMemory(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                        allocateAttachmentMemory(*m_colorImage, attachment);
 
                         auto colorViewInfo =
                             imageViewCreateInfo()
@@ -266,7 +306,8 @@ bool Swapchain::prepare(renderer::OperationContext& context)
     vkWaitForFences(m_context.device(), 1, m_inFlightFences[m_currentFrame].handlePtr(), VK_TRUE,
         UINT64_MAX);
 
-    m_resourcesInUse[m_currentFrame].sets.clear();
+    m_context.device().releaseFence(
+        m_inFlightFences[m_currentFrame], *m_transientDescriptorAllocator);
 
     VkResult result = vkAcquireNextImageKHR(m_context.device(), *m_swapchain, UINT64_MAX,
         m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &m_currentImage);
@@ -290,6 +331,8 @@ bool Swapchain::prepare(renderer::OperationContext& context)
     commandBuffer.reset();
     ASSERT(commandBuffer.begin() == VK_SUCCESS, "failed to begin recording command buffer!");
 
+    m_uploadToken = m_context.device().uploadManager().acquire(commandBuffer);
+
     return true;
 }
 
@@ -298,15 +341,23 @@ void Swapchain::present(renderer::OperationContext& context)
     const auto& commandBuffer = *get(context).commandBuffer;
     ASSERT(commandBuffer.end() == VK_SUCCESS, "failed to record command buffer!");
 
-    m_resourcesInUse[m_currentFrame] = std::move(commandBuffer.resourcesInUse());
-
     std::vector<VkPipelineStageFlags> waitStages = {
         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
     };
+
+    //  writes made up to now are copied ahead of the frame, in the batch retired with its fence
+    std::vector<VkCommandBuffer> commandBuffers{ commandBuffer.handle() };
+    if (m_context.device().stagingRing().record(
+            m_stagingCommandBuffers[m_currentFrame], m_inFlightFences[m_currentFrame]))
+    {
+        commandBuffers.insert(
+            commandBuffers.begin(), m_stagingCommandBuffers[m_currentFrame].handle());
+    }
+
     auto submitInfo =
         handles::SubmitInfo{}
-            .commandBufferCount(1)
-            .pCommandBuffers(commandBuffer.handlePtr())
+            .commandBufferCount(commandBuffers.size())
+            .pCommandBuffers(commandBuffers.data())
             .signalSemaphoreCount(1)
             .pSignalSemaphores(m_renderFinishedSemaphores[m_currentFrame].handlePtr());
 
@@ -316,19 +367,40 @@ void Swapchain::present(renderer::OperationContext& context)
     {
         std::copy(m_renderWaitSemaphores.begin(), m_renderWaitSemaphores.end(),
             std::back_inserter(waitSemaphores));
-        waitStages.push_back(VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+        //  compute results are read as vertices or as indirect commands
+        waitStages.resize(waitSemaphores.size(),
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
         m_renderWaitSemaphores.clear();
     }
 
-    submitInfo.waitSemaphoreCount(waitSemaphores.size())
+    //  binary semaphores ignore their wait values, only the upload one is a timeline semaphore
+    std::vector<uint64_t> waitValues(waitSemaphores.size(), 0);
+    if (m_uploadToken.has_value())
+    {
+        waitSemaphores.push_back(m_context.device().uploadManager().semaphore());
+        waitStages.push_back(UploadManager::s_consumerStages);
+        waitValues.push_back(m_uploadToken.value());
+        m_uploadToken.reset();
+    }
+
+    const auto timelineInfo = handles::TimelineSemaphoreSubmitInfo{}
+                                  .waitSemaphoreValueCount(waitValues.size())
+                                  .pWaitSemaphoreValues(waitValues.data());
+
+    submitInfo.pNext(&timelineInfo)
+        .waitSemaphoreCount(waitSemaphores.size())
         .pWaitSemaphores(waitSemaphores.data())
         .pWaitDstStageMask(waitStages.data());
 
+    m_context.device().flushMappedMemory();
+
     ASSERT(m_context.device()
                 .queue(handles::GRAPHICS_COMPUTE)
                 .lock()
                 ->submit(1, &submitInfo, m_inFlightFences[m_currentFrame]) == VK_SUCCESS,
         "failed to submit draw command buffer!");
+    m_context.device().recordFence(
+        m_inFlightFences[m_currentFrame], *m_transientDescriptorAllocator, true);
 
     VkResult result =
         m_context.device()
@@ -407,6 +479,11 @@ uint32_t Swapchain::descriptorsRequired() const
     return m_maxFramesInFlight;
 }
 
+TransientDescriptorAllocator& Swapchain::transientDescriptorAllocator()
+{
+    return *m_transientDescriptorAllocator;
+}
+
 handles::Framebuffer& Swapchain::currentFramebuffer()
 {
     return m_swapChainFramebuffers[m_currentImage];
@@ -7,10 +7,12 @@
 #include "handles/framebuffer.hpp"
 
 #include "ispecific_operation_target.hpp"
+#include "upload_manager.hpp"
 
 #include <iswapchain.hpp>
 
 #include <memory>
+#include <optional>
 
 namespace renderer {
 class IVulkanSurface;
@@ -18,6 +20,7 @@ class IVulkanSurface;
 namespace vk {
 
 class GraphicsContext;
+class TransientDescriptorAllocator;
 
 namespace handles {
 class Surface;
@@ -63,6 +66,7 @@ public:
     virtual void populateWaitInfo(OperationContext& context) override;
     virtual void waitFor(OperationContext& context) override;
     virtual uint32_t descriptorsRequired() const override;
+    virtual TransientDescriptorAllocator& transientDescriptorAllocator() override;
 
 private:
     void recreate();
@@ -100,13 +104,14 @@ private:
     int m_maxFramesInFlight;
 
     handles::HandleVector<handles::CommandBuffer> m_commandBuffers;
-
-    std::vector<handles::CommandBuffer::Resources> m_resourcesInUse;
+    handles::HandleVector<handles::CommandBuffer> m_stagingCommandBuffers;
 
     std::vector<VkSemaphore> m_renderWaitSemaphores;
+    std::optional<UploadManager::Token> m_uploadToken;
     handles::HandleVector<handles::Semaphore> m_imageAvailableSemaphores;
     handles::HandleVector<handles::Semaphore> m_renderFinishedSemaphores;
     handles::HandleVector<handles::Fence> m_inFlightFences;
+    std::unique_ptr<TransientDescriptorAllocator> m_transientDescriptorAllocator;
 
     handles::HandleVector<handles::Image> m_swapChainImages;
     handles::HandleVector<handles::ImageView> m_swapChainImageViews;
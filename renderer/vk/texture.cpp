@@ -4,7 +4,10 @@
 #include "types.hpp"
 #include "shader_interface_handle.hpp"
 
-#include "handles/buffer.hpp"
+#include "upload_manager.hpp"
+#include "bindless_texture_table.hpp"
+
+#include "handles/command_buffer.hpp"
 #include "handles/image.hpp"
 #include "handles/image_view.hpp"
 #include "handles/sampler.hpp"
@@ -24,17 +27,17 @@ Texture::Texture(const GraphicsContext& context, ITexture::CreateInfo createInfo
 
     ASSERT(createInfo.pixels, "failed to load texture image!");
 
-    handles::Buffer stagingBuffer(m_context.device(),
-        handles::Buffer::staging().size(createInfo.imageSize));
-    stagingBuffer
-        .allocateAndBindMemory(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
-        .lock()
-        ->map()
-        .lock()
-        ->write(createInfo.pixels, createInfo.imageSize);
-
-    m_image = std::make_unique<handles::Image>(m_context.device(),
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(m_context.device().physicalDevice(), s_imageFormat,
+        &formatProperties);
+
+    if (!(formatProperties.optimalTilingFeatures &
+            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+    {
+        throw std::runtime_error("texture image format does not support linear blitting!");
+    }
+
+    m_image = std::make_shared<handles::Image>(m_context.device(),
         handles::ImageCreateInfo()
             .imageType(VK_IMAGE_TYPE_2D)
             .extent(
@@ -58,9 +61,6 @@ Texture::Texture(const GraphicsContext& context, ITexture::CreateInfo createInfo
             .baseMipLevel(0)
             .levelCount(m_mipLevels);
 
-    m_image->transitionLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        subresourceRange);
-
     const auto copyRegion =
         BufferImageCopy{}
             .bufferOffset(0)
@@ -76,9 +76,16 @@ Texture::Texture(const GraphicsContext& context, ITexture::CreateInfo createInfo
             .imageExtent(
                 VkExtent3D{ static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height), 1 });
 
-    stagingBuffer.copyToImage(*m_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, copyRegion);
-
-    generateMipmaps();
+    //  transfer queues can't blit, so the mip chain is generated once the consumer acquires it
+    m_context.device().uploadManager().upload(createInfo.pixels, createInfo.imageSize, m_image,
+        copyRegion, subresourceRange,
+        [image = std::weak_ptr<handles::Image>(m_image), width = m_width, height = m_height,
+            mipLevels = m_mipLevels](const handles::CommandBuffer& commandBuffer) {
+            if (auto imagePtr = image.lock())
+            {
+                generateMipmaps(commandBuffer, *imagePtr, width, height, mipLevels);
+            }
+        });
 
     m_imageView = std::make_unique<handles::ImageView>(m_context.device(),
         handles::ImageViewCreateInfo()
@@ -105,10 +112,24 @@ Texture::Texture(const GraphicsContext& context, ITexture::CreateInfo createInfo
             .compareOp(VK_COMPARE_OP_ALWAYS)
             .borderColor(VK_BORDER_COLOR_INT_OPAQUE_BLACK)
             .unnormalizedCoordinates(VK_FALSE));
+
+    if (auto* table = m_context.device().bindlessTextureTable(); table)
+    {
+        m_bindlessIndex = table->add(
+            DescriptorImageInfo{}
+                .imageLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+                .imageView(*m_imageView)
+                .sampler(*m_sampler));
+    }
 }
 
 Texture::~Texture()
 {
+    if (m_bindlessIndex != s_invalidBindlessIndex)
+    {
+        m_context.device().bindlessTextureTable()->remove(m_bindlessIndex);
+    }
+
     m_sampler.reset();
     m_imageView.reset();
     m_image.reset();
@@ -137,23 +158,15 @@ std::shared_ptr<IShaderInterfaceHandle> Texture::uniformHandle()
     return m_handle;
 }
 
-void Texture::generateMipmaps()
+void Texture::generateMipmaps(const handles::CommandBuffer& commandBuffer,
+    const handles::Image& image,
+    int32_t width,
+    int32_t height,
+    uint32_t mipLevels)
 {
-    VkFormatProperties formatProperties;
-    vkGetPhysicalDeviceFormatProperties(m_context.device().physicalDevice(), s_imageFormat,
-        &formatProperties);
-
-    if (!(formatProperties.optimalTilingFeatures &
-            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
-    {
-        throw std::runtime_error("texture image format does not support linear blitting!");
-    }
-
-    auto oneTimeCommand = m_context.device().oneTimeCommand(handles::GRAPHICS_COMPUTE);
-
     auto barrier =
         ImageMemoryBarrier{}
-            .image(*m_image)
+            .image(image)
             .srcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
             .dstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
             .subresourceRange(
@@ -163,10 +176,10 @@ void Texture::generateMipmaps()
                     .layerCount(1)
                     .levelCount(1));
 
-    int32_t mipWidth = m_width;
-    int32_t mipHeight = m_height;
+    int32_t mipWidth = width;
+    int32_t mipHeight = height;
 
-    for (uint32_t i = 1; i < m_mipLevels; i++)
+    for (uint32_t i = 1; i < mipLevels; i++)
     {
         barrier.oldLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
             .newLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
@@ -175,7 +188,7 @@ void Texture::generateMipmaps()
             .subresourceRange()
             .baseMipLevel(i - 1);
 
-        oneTimeCommand().pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+        commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, std::span{ &barrier, 1 });
 
         auto blit = ImageBlit{};
@@ -197,7 +210,7 @@ void Texture::generateMipmaps()
                     .layerCount(1)
                     .mipLevel(i));
 
-        oneTimeCommand().blitImage(*m_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, *m_image,
+        commandBuffer.blitImage(image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, std::span{ &blit, 1 }, VK_FILTER_LINEAR);
 
         barrier.oldLayout(VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
@@ -205,7 +218,7 @@ void Texture::generateMipmaps()
             .srcAccessMask(VK_ACCESS_TRANSFER_READ_BIT)
             .dstAccessMask(VK_ACCESS_SHADER_READ_BIT);
 
-        oneTimeCommand().pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+        commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, std::span{ &barrier, 1 });
 
         if (mipWidth > 1) mipWidth /= 2;
@@ -217,9 +230,9 @@ void Texture::generateMipmaps()
         .oldLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
         .newLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
         .subresourceRange()
-        .baseMipLevel(m_mipLevels - 1);
+        .baseMipLevel(mipLevels - 1);
 
-    oneTimeCommand().pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+    commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, std::span{ &barrier, 1 });
 }
 
@@ -11,6 +11,7 @@ namespace renderer::vk {
 class GraphicsContext;
 
 namespace handles {
+class CommandBuffer;
 class Image;
 class ImageView;
 class Sampler;
@@ -27,10 +28,16 @@ public:
     virtual std::shared_ptr<ShaderResource::Descriptor> fetchDescriptor() override;
     virtual std::shared_ptr<IShaderInterfaceHandle> uniformHandle() override;
 
+    virtual uint32_t bindlessIndex() const override { return m_bindlessIndex; }
+
 private:
     virtual void freeDescriptor(const ShaderResource::Descriptor& descriptor) override;
 
-    void generateMipmaps();
+    static void generateMipmaps(const handles::CommandBuffer& commandBuffer,
+        const handles::Image& image,
+        int32_t width,
+        int32_t height,
+        uint32_t mipLevels);
 
 private:
     const GraphicsContext& m_context;
@@ -38,9 +45,10 @@ private:
     uint32_t m_mipLevels;
     int m_width;
     int m_height;
+    uint32_t m_bindlessIndex = s_invalidBindlessIndex;
 
     std::shared_ptr<IShaderInterfaceHandle> m_handle;
-    std::unique_ptr<handles::Image> m_image;
+    std::shared_ptr<handles::Image> m_image;
     std::unique_ptr<handles::ImageView> m_imageView;
     std::unique_ptr<handles::Sampler> m_sampler;
 };
@@ -0,0 +1,101 @@
+#include "transient_descriptor_allocator.hpp"
+
+#include "handles/descriptor_pool.hpp"
+#include "handles/descriptor_set.hpp"
+#include "handles/device.hpp"
+
+#include <array>
+
+namespace renderer::vk {
+
+TransientDescriptorAllocator::TransientDescriptorAllocator(const handles::Device& device)
+    : m_device(device)
+    , m_epoch(0)
+{}
+
+TransientDescriptorAllocator::~TransientDescriptorAllocator()
+{
+    m_segments.clear();
+    m_free.clear();
+    m_used.clear();
+    m_current.reset();
+}
+
+std::shared_ptr<handles::DescriptorSet> TransientDescriptorAllocator::allocate(
+    const handles::DescriptorSetLayout& layout)
+{
+    ++m_useCount;
+
+    if (!m_current) nextPool();
+    if (auto set = m_current->tryAllocateTransientSet(layout); set) return set;
+
+    nextPool();
+
+    auto set = m_current->tryAllocateTransientSet(layout);
+    ASSERT(set, "failed to allocate transient descriptor set");
+
+    return set;
+}
+
+void TransientDescriptorAllocator::record(VkFence fence)
+{
+    ++m_epoch;
+
+    //  the current pool is shared with the next submission unless something was allocated from it
+    if ((!m_current || m_current->isEmpty()) && m_used.empty()) return;
+
+    if (m_current) m_used.push_back(std::move(m_current));
+    m_segments.push(fence, std::move(m_used));
+    m_used.clear();
+}
+
+void TransientDescriptorAllocator::release(VkFence fence)
+{
+    m_segments.release(fence, [&](auto& pools) {
+        for (auto& pool : pools)
+        {
+            pool->reset();
+            m_free.push_back(std::move(pool));
+        }
+    });
+}
+
+std::unique_ptr<handles::DescriptorPool> TransientDescriptorAllocator::createPool() const
+{
+    static constexpr std::array s_types{
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    };
+
+    std::vector<handles::DescriptorPoolSize> poolSizes;
+    for (auto type : s_types)
+    {
+        poolSizes.push_back(
+            handles::DescriptorPoolSize{}.type(type).descriptorCount(s_poolDescriptorCount));
+    }
+
+    return std::make_unique<handles::DescriptorPool>(m_device,
+        handles::DescriptorPoolCreateInfo{}
+            .maxSets(s_poolSetCount)
+            .poolSizeCount(poolSizes.size())
+            .pPoolSizes(poolSizes.data()));
+}
+
+void TransientDescriptorAllocator::nextPool()
+{
+    if (m_current) m_used.push_back(std::move(m_current));
+
+    if (m_free.empty())
+    {
+        m_current = createPool();
+    }
+    else
+    {
+        m_current = std::move(m_free.back());
+        m_free.pop_back();
+    }
+}
+
+}    //  namespace renderer::vk
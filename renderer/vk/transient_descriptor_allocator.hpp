@@ -0,0 +1,68 @@
+#pragma once
+
+#include "fence_segments.hpp"
+#include "ifenced_resource.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class DescriptorPool;
+class DescriptorSet;
+class DescriptorSetLayout;
+class Device;
+}
+
+//  Descriptor sets which live for a single submission. They are bump allocated from pools created
+//  without VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, the pools are handed to the fence of
+//  the submission and reset as a whole once it has been waited for, so the pool count stays
+//  bounded by the peak usage of the frames in flight. Every submission target has an allocator of
+//  its own, pools are created on first use
+class TransientDescriptorAllocator : public IFencedResource
+{
+public:
+    static constexpr uint32_t s_poolSetCount = 256;
+    //  per descriptor type
+    static constexpr uint32_t s_poolDescriptorCount = 1024;
+
+public:
+    TransientDescriptorAllocator(const handles::Device& device);
+    TransientDescriptorAllocator(const TransientDescriptorAllocator& other) = delete;
+    ~TransientDescriptorAllocator();
+
+    //  the set is valid until the submission it is recorded into has been waited for
+    std::shared_ptr<handles::DescriptorSet> allocate(const handles::DescriptorSetLayout& layout);
+
+    //  hands the pools used since the last call to the fence of the submission
+    virtual void record(VkFence fence) override;
+    virtual void release(VkFence fence) override;
+
+    //  changes with every record, so the sets of a previous submission are never reused
+    uint64_t epoch() const { return m_epoch; }
+
+    //  changes whenever a set is allocated or one of the current submission is bound again,
+    //  commands recorded in between are valid for this submission only
+    uint64_t useCount() const { return m_useCount; }
+    void countUse() { ++m_useCount; }
+
+private:
+    std::unique_ptr<handles::DescriptorPool> createPool() const;
+    void nextPool();
+
+private:
+    const handles::Device& m_device;
+
+    std::unique_ptr<handles::DescriptorPool> m_current;
+    std::vector<std::unique_ptr<handles::DescriptorPool>> m_used;
+    std::vector<std::unique_ptr<handles::DescriptorPool>> m_free;
+    FenceSegments<std::vector<std::unique_ptr<handles::DescriptorPool>>> m_segments;
+
+    uint64_t m_epoch;
+    uint64_t m_useCount = 0;
+};
+
+}    //  namespace renderer::vk
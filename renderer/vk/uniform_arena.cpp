@@ -0,0 +1,116 @@
+#include "uniform_arena.hpp"
+
+#include "handles/buffer.hpp"
+#include "handles/device.hpp"
+#include "handles/memory.hpp"
+
+namespace renderer::vk {
+
+UniformArena::UniformArena(const handles::Device& device)
+    : m_device(device)
+    , m_alignment(device.physicalDeviceProperties().limits.minUniformBufferOffsetAlignment)
+    , m_head(0)
+    , m_epoch(1)
+{
+    m_current = createBlock();
+}
+
+UniformArena::~UniformArena()
+{
+    m_segments.clear();
+    m_blocks.clear();
+}
+
+UniformArena::Slice UniformArena::push(const void* src, VkDeviceSize size)
+{
+    ASSERT(size <= s_blockSize, "uniform data doesn't fit into an arena block");
+
+    VkDeviceSize offset = (m_head + m_alignment - 1) / m_alignment * m_alignment;
+    if (offset + size > s_blockSize)
+    {
+        nextBlock();
+        offset = 0;
+    }
+    m_head = offset + size;
+    ++m_useCount;
+
+    m_blocks[m_current]->memory().lock()->mapped->writeAndSync(src, size, offset);
+
+    return Slice{ .blockId = m_current, .offset = offset };
+}
+
+void UniformArena::populateDescriptor(
+    Descriptor& descriptor, Slice slice, VkDeviceSize range) const
+{
+    auto& block = *m_blocks[slice.blockId];
+
+    //  all slices of a block share a descriptor set, they differ in the dynamic offset only
+    descriptor.id.descriptorId = 0;
+    descriptor.id.bufferId = slice.blockId;
+    descriptor.id.resourceId = id();
+    descriptor.descriptorBufferInfo = DescriptorBufferInfo{}.buffer(block).offset(0).range(range);
+    descriptor.dynamicOffset = slice.offset;
+    descriptor.memory = block.memory();
+}
+
+const handles::Buffer& UniformArena::buffer(Slice slice) const
+{
+    return *m_blocks[slice.blockId];
+}
+
+void UniformArena::record(VkFence fence)
+{
+    //  pushed even if nothing was written, completedEpoch() has to account for every submission
+    if (m_head) nextBlock();
+
+    m_segments.push(fence, Blocks{ .epoch = m_epoch, .blocks = std::move(m_used) });
+    m_used.clear();
+
+    ++m_epoch;
+}
+
+void UniformArena::release(VkFence fence)
+{
+    m_segments.releaseInOrder(fence, [&](Blocks& used) {
+        m_free.insert(m_free.end(), used.blocks.begin(), used.blocks.end());
+    });
+}
+
+uint64_t UniformArena::completedEpoch() const
+{
+    return m_segments.empty() ? m_epoch - 1 : m_segments.front().payload.epoch - 1;
+}
+
+uint32_t UniformArena::createBlock()
+{
+    auto& block = m_blocks.emplace_back(std::make_unique<handles::Buffer>(m_device,
+        handles::BufferCreateInfo{}
+            .size(s_blockSize)
+            .usage(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)
+            .sharingMode(VK_SHARING_MODE_EXCLUSIVE)));
+    block
+        ->allocateAndBindPreferredMemory(
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        .lock()
+        ->map();
+
+    return m_blocks.size() - 1;
+}
+
+void UniformArena::nextBlock()
+{
+    m_used.push_back(m_current);
+    m_head = 0;
+
+    if (m_free.empty())
+    {
+        m_current = createBlock();
+    }
+    else
+    {
+        m_current = m_free.back();
+        m_free.pop_back();
+    }
+}
+
+}    //  namespace renderer::vk
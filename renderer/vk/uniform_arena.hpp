@@ -0,0 +1,86 @@
+#pragma once
+
+#include "fence_segments.hpp"
+#include "ifenced_resource.hpp"
+#include "shader_resource.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class Buffer;
+class Device;
+}
+
+//  Dynamic uniform data written during a submission. Every write bump allocates a fresh slice of a
+//  persistently mapped block, so draws recorded before the write keep reading the old data. Blocks
+//  are handed to the fence of the submission and reused once it has been waited for, so the memory
+//  used scales with the data written per submission instead of objects times frames in flight.
+//  Blocks are vertex buffers as well and take the per instance data of instanced draws
+class UniformArena
+    : public ShaderResource
+    , public IFencedResource
+{
+public:
+    static constexpr VkDeviceSize s_blockSize = 4 * 1024 * 1024;
+
+    struct Slice
+    {
+        uint64_t blockId;
+        VkDeviceSize offset;
+    };
+
+public:
+    UniformArena(const handles::Device& device);
+    UniformArena(const UniformArena& other) = delete;
+    ~UniformArena();
+
+    Slice push(const void* src, VkDeviceSize size);
+    void populateDescriptor(Descriptor& descriptor, Slice slice, VkDeviceSize range) const;
+    const handles::Buffer& buffer(Slice slice) const;
+
+    //  hands the blocks written since the last call to the fence of the submission
+    virtual void record(VkFence fence) override;
+    virtual void release(VkFence fence) override;
+
+    //  submission the arena is written for, changes with every record
+    uint64_t epoch() const { return m_epoch; }
+
+    //  every submission up to this epoch has been waited for
+    uint64_t completedEpoch() const;
+
+    //  changes whenever a slice is pushed or a descriptor of one is bound, commands recorded in
+    //  between read data of the current submission
+    uint64_t useCount() const { return m_useCount; }
+    void countUse() { ++m_useCount; }
+
+private:
+    struct Blocks
+    {
+        uint64_t epoch;
+        std::vector<uint32_t> blocks;
+    };
+
+    uint32_t createBlock();
+    void nextBlock();
+
+private:
+    const handles::Device& m_device;
+    const VkDeviceSize m_alignment;
+
+    std::vector<std::unique_ptr<handles::Buffer>> m_blocks;
+    uint32_t m_current;
+    VkDeviceSize m_head;
+    std::vector<uint32_t> m_used;
+    std::vector<uint32_t> m_free;
+    FenceSegments<Blocks> m_segments;
+
+    uint64_t m_epoch;
+    uint64_t m_useCount = 0;
+};
+
+}    //  namespace renderer::vk
@@ -0,0 +1,323 @@
+#include "upload_manager.hpp"
+
+#include "handles/buffer.hpp"
+#include "handles/command_buffer.hpp"
+#include "handles/command_pool.hpp"
+#include "handles/device.hpp"
+#include "handles/image.hpp"
+#include "handles/memory.hpp"
+#include "handles/queue.hpp"
+#include "handles/semaphore.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace renderer::vk {
+
+UploadManager::UploadManager(const handles::Device& device)
+    : m_device(device)
+    , m_transferFamily(device.queueFamilies().queueFamilyIndex(handles::TRANSFER))
+    , m_consumerFamily(device.queueFamilies().queueFamilyIndex(handles::GRAPHICS_COMPUTE))
+    , m_submitted(0)
+{
+    const auto typeInfo = handles::SemaphoreTypeCreateInfo{}
+                              .semaphoreType(VK_SEMAPHORE_TYPE_TIMELINE)
+                              .initialValue(m_submitted);
+    m_semaphore = std::make_unique<handles::Semaphore>(device,
+        handles::SemaphoreCreateInfo{}.pNext(&typeInfo));
+    m_stagingRing = std::make_unique<StagingRing>(device);
+}
+
+UploadManager::~UploadManager()
+{
+    //  the recording batch is dropped, its destinations may be gone already
+    wait(m_submitted);
+
+    m_recording.reset();
+    m_inFlight.clear();
+    m_stagingRing.reset();
+    m_semaphore.reset();
+}
+
+UploadManager::Token UploadManager::upload(
+    const void* src, VkDeviceSize size, VkBuffer dst, VkDeviceSize dstOffset)
+{
+    if (!size) return recording().token;
+
+    const Staged staged = stage(src, size);
+    auto& batch = recording();
+    const Token token = batch.token;
+
+    const VkBufferCopy region{ .srcOffset = staged.offset, .dstOffset = dstOffset, .size = size };
+    batch.commandBuffer->copyBuffer(staged.buffer, dst, { &region, 1 });
+    if (std::find(batch.buffers.begin(), batch.buffers.end(), dst) == batch.buffers.end())
+    {
+        batch.buffers.push_back(dst);
+    }
+
+    if (batch.size >= s_maxBatchSize) submit();
+
+    return token;
+}
+
+UploadManager::Token UploadManager::upload(const void* src,
+    VkDeviceSize size,
+    std::shared_ptr<const handles::Image> dst,
+    BufferImageCopy region,
+    ImageSubresourceRange range,
+    Finalize finalize)
+{
+    const Staged staged = stage(src, size);
+    auto& batch = recording();
+    const Token token = batch.token;
+
+    dst->transitionLayout(*batch.commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, range);
+
+    region.bufferOffset(staged.offset);
+    batch.commandBuffer->copyBufferToImage(staged.buffer, *dst,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, { &region, 1 });
+
+    batch.images.push_back(
+        PendingImage{ .image = std::move(dst), .range = range, .finalize = std::move(finalize) });
+
+    if (batch.size >= s_maxBatchSize) submit();
+
+    return token;
+}
+
+UploadManager::Token UploadManager::submit()
+{
+    if (!m_recording.has_value()) return m_submitted;
+
+    auto& batch = m_recording.value();
+
+    if (ownershipTransfer())
+    {
+        //  release half of the queue family ownership transfer, acquire() records the other one
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        for (VkBuffer buffer : batch.buffers)
+        {
+            bufferBarriers.push_back(VkBufferMemoryBarrier{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = 0,
+                .srcQueueFamilyIndex = m_transferFamily,
+                .dstQueueFamilyIndex = m_consumerFamily,
+                .buffer = buffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE,
+            });
+        }
+
+        std::vector<ImageMemoryBarrier> imageBarriers;
+        for (const auto& pending : batch.images)
+        {
+            imageBarriers.push_back(ImageMemoryBarrier{}
+                                        .srcAccessMask(VK_ACCESS_TRANSFER_WRITE_BIT)
+                                        .dstAccessMask(0)
+                                        .oldLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+                                        .newLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+                                        .srcQueueFamilyIndex(m_transferFamily)
+                                        .dstQueueFamilyIndex(m_consumerFamily)
+                                        .image(*pending.image)
+                                        .subresourceRange(pending.range));
+        }
+
+        batch.commandBuffer->pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, imageBarriers, {}, bufferBarriers);
+    }
+
+    ASSERT(batch.commandBuffer->end() == VK_SUCCESS, "failed to end upload command buffer");
+
+    const Token value = batch.token;
+    const auto timelineInfo =
+        handles::TimelineSemaphoreSubmitInfo{}.signalSemaphoreValueCount(1).pSignalSemaphoreValues(
+            &value);
+    const auto submitInfo = handles::SubmitInfo{}
+                                .pNext(&timelineInfo)
+                                .commandBufferCount(1)
+                                .pCommandBuffers(batch.commandBuffer->handlePtr())
+                                .signalSemaphoreCount(1)
+                                .pSignalSemaphores(m_semaphore->handlePtr());
+
+    ASSERT(m_device.queue(handles::TRANSFER).lock()->submit(1, &submitInfo, VK_NULL_HANDLE) ==
+            VK_SUCCESS,
+        "failed to submit upload command buffer");
+
+    m_stagingRing->close(value);
+    m_submitted = value;
+    m_inFlight.push_back(std::move(batch));
+    m_recording.reset();
+
+    return m_submitted;
+}
+
+std::optional<UploadManager::Token> UploadManager::acquire(
+    const handles::CommandBuffer& commandBuffer)
+{
+    submit();
+
+    for (auto& batch : m_inFlight)
+    {
+        if (batch.acquired) continue;
+
+        if (ownershipTransfer())
+        {
+            std::vector<VkBufferMemoryBarrier> bufferBarriers;
+            for (VkBuffer buffer : batch.buffers)
+            {
+                bufferBarriers.push_back(VkBufferMemoryBarrier{
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                    .srcAccessMask = 0,
+                    .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                        VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+                        VK_ACCESS_SHADER_READ_BIT,
+                    .srcQueueFamilyIndex = m_transferFamily,
+                    .dstQueueFamilyIndex = m_consumerFamily,
+                    .buffer = buffer,
+                    .offset = 0,
+                    .size = VK_WHOLE_SIZE,
+                });
+            }
+
+            std::vector<ImageMemoryBarrier> imageBarriers;
+            for (const auto& pending : batch.images)
+            {
+                imageBarriers.push_back(
+                    ImageMemoryBarrier{}
+                        .srcAccessMask(0)
+                        .dstAccessMask(VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                            VK_ACCESS_SHADER_READ_BIT)
+                        .oldLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+                        .newLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+                        .srcQueueFamilyIndex(m_transferFamily)
+                        .dstQueueFamilyIndex(m_consumerFamily)
+                        .image(*pending.image)
+                        .subresourceRange(pending.range));
+            }
+
+            //  the source stage matches the stage the consumer submission waits the token at
+            commandBuffer.pipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, s_consumerStages, 0,
+                imageBarriers, {}, bufferBarriers);
+        }
+
+        for (const auto& pending : batch.images)
+        {
+            if (pending.finalize) pending.finalize(commandBuffer);
+        }
+
+        batch.acquired = true;
+    }
+
+    collect();
+
+    if (m_inFlight.empty()) return std::nullopt;
+
+    return m_submitted;
+}
+
+bool UploadManager::isComplete(Token token) const
+{
+    return completedToken() >= token;
+}
+
+void UploadManager::wait(Token token)
+{
+    if (m_recording.has_value() && token >= m_recording->token) submit();
+
+    const auto waitInfo = handles::SemaphoreWaitInfo{}
+                              .semaphoreCount(1)
+                              .pSemaphores(m_semaphore->handlePtr())
+                              .pValues(&token);
+    ASSERT(vkWaitSemaphores(m_device, &waitInfo, (std::numeric_limits<uint64_t>::max)()) ==
+            VK_SUCCESS,
+        "failed to wait for upload semaphore");
+}
+
+UploadManager::Token UploadManager::lastToken() const
+{
+    return m_recording.has_value() ? m_recording->token : m_submitted;
+}
+
+UploadManager::Batch& UploadManager::recording()
+{
+    if (!m_recording.has_value())
+    {
+        auto& batch = m_recording.emplace();
+        batch.token = m_submitted + 1;
+        batch.commandBuffer = std::make_unique<handles::CommandBuffer>(
+            m_device.commandPool(handles::TRANSFER).lock()->allocateBuffer());
+
+        ASSERT(batch.commandBuffer->begin(handles::CommandBufferBeginInfo{}.flags(
+                   VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)) == VK_SUCCESS,
+            "failed to begin upload command buffer");
+    }
+
+    return m_recording.value();
+}
+
+UploadManager::Staged UploadManager::stage(const void* src, VkDeviceSize size)
+{
+    auto offset = m_stagingRing->stage(src, size);
+    if (!offset.has_value() && size < StagingRing::s_defaultSize)
+    {
+        //  the ring is full of batches in flight, finished ones are reclaimed first. The recording
+        //  one is submitted and everything is waited for if that isn't enough
+        m_stagingRing->releaseUpTo(completedToken());
+        offset = m_stagingRing->stage(src, size);
+        if (!offset.has_value())
+        {
+            submit();
+            wait(m_submitted);
+            m_stagingRing->releaseUpTo(m_submitted);
+            offset = m_stagingRing->stage(src, size);
+        }
+    }
+
+    auto& batch = recording();
+    batch.size += size;
+
+    if (offset.has_value()) return Staged{ .buffer = m_stagingRing->buffer(), .offset = *offset };
+
+    //  larger than the whole ring
+    auto& stagingBuffer = batch.stagingBuffers.emplace_back(
+        std::make_unique<handles::Buffer>(m_device, handles::Buffer::staging().size(size)));
+    stagingBuffer
+        ->allocateAndBindMemory(
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+        .lock()
+        ->map()
+        .lock()
+        ->write(src, size);
+
+    return Staged{ .buffer = *stagingBuffer, .offset = 0 };
+}
+
+UploadManager::Token UploadManager::completedToken() const
+{
+    uint64_t value = 0;
+    ASSERT(vkGetSemaphoreCounterValue(m_device, *m_semaphore, &value) == VK_SUCCESS,
+        "failed to get upload semaphore value");
+
+    return value;
+}
+
+bool UploadManager::ownershipTransfer() const
+{
+    return m_transferFamily != m_consumerFamily;
+}
+
+void UploadManager::collect()
+{
+    const Token completed = completedToken();
+    m_stagingRing->releaseUpTo(completed);
+
+    while (!m_inFlight.empty() && m_inFlight.front().acquired &&
+        m_inFlight.front().token <= completed)
+    {
+        m_inFlight.pop_front();
+    }
+}
+
+}    //  namespace renderer::vk
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "staging_ring.hpp"
+#include "types.hpp"
+
+#include "handles/image.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace renderer::vk {
+
+namespace handles {
+class Buffer;
+class CommandBuffer;
+class Device;
+class Semaphore;
+}
+
+//  Uploads device local resources through the transfer queue without blocking the host. Copies are
+//  batched into a single command buffer that signals a timeline semaphore on submission, the value
+//  it signals is the completion token of every upload in the batch. Consumers acquire submitted
+//  batches into their own command buffer and wait for the returned token on submission. The data
+//  is staged in a ring of its own, the transfer queue is the only one reading it, and the space
+//  is reclaimed once the token of the batch has been signaled
+class UploadManager
+{
+public:
+    using Token = uint64_t;
+
+    //  recorded on the consumer queue after the image ownership has been acquired, the whole
+    //  uploaded range is in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL at that point
+    using Finalize = std::function<void(const handles::CommandBuffer&)>;
+
+    //  stages which may read the uploaded data on the consumer queue
+    static constexpr VkPipelineStageFlags s_consumerStages = VK_PIPELINE_STAGE_TRANSFER_BIT |
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    //  a batch may be recorded while the previous one is in flight
+    static constexpr VkDeviceSize s_maxBatchSize = StagingRing::s_defaultSize / 2;
+
+public:
+    UploadManager(const handles::Device& device);
+    UploadManager(const UploadManager& other) = delete;
+    ~UploadManager();
+
+    Token upload(const void* src, VkDeviceSize size, VkBuffer dst, VkDeviceSize dstOffset);
+    Token upload(const void* src,
+        VkDeviceSize size,
+        std::shared_ptr<const handles::Image> dst,
+        BufferImageCopy region,
+        ImageSubresourceRange range,
+        Finalize finalize = {});
+
+    //  submits the recording batch, uploads are submitted by acquire otherwise
+    Token submit();
+
+    //  records ownership acquisition of every submitted batch into the consumer command buffer,
+    //  returns the value the consumer submission has to wait for or nothing if there is none
+    std::optional<Token> acquire(const handles::CommandBuffer& commandBuffer);
+
+    bool isComplete(Token token) const;
+    void wait(Token token);
+
+    //  the token of the last upload recorded, submitted or not
+    Token lastToken() const;
+
+    const handles::Semaphore& semaphore() const { return *m_semaphore; }
+
+private:
+    struct PendingImage
+    {
+        std::shared_ptr<const handles::Image> image;
+        ImageSubresourceRange range;
+        Finalize finalize;
+    };
+
+    struct Staged
+    {
+        VkBuffer buffer;
+        VkDeviceSize offset;
+    };
+
+    struct Batch
+    {
+        Token token;
+        std::unique_ptr<handles::CommandBuffer> commandBuffer;
+        std::vector<std::unique_ptr<handles::Buffer>> stagingBuffers;
+        std::vector<VkBuffer> buffers;
+        std::vector<PendingImage> images;
+        VkDeviceSize size = 0;
+        bool acquired = false;
+    };
+
+    Batch& recording();
+    //  submits the recording batch if the ring is full, so the batch is fetched after staging
+    Staged stage(const void* src, VkDeviceSize size);
+    Token completedToken() const;
+    bool ownershipTransfer() const;
+    void collect();
+
+private:
+    const handles::Device& m_device;
+    const uint32_t m_transferFamily;
+    const uint32_t m_consumerFamily;
+
+    std::unique_ptr<handles::Semaphore> m_semaphore;
+    std::unique_ptr<StagingRing> m_stagingRing;
+    Token m_submitted;
+
+    std::optional<Batch> m_recording;
+    std::deque<Batch> m_inFlight;
+};
+
+}    //  namespace renderer::vk
@@ -0,0 +1,19 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) out vec4 outColor;
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexture;
+
+//  TextureTable, every texture of the context
+layout(set = 2, binding = 0) uniform sampler2D textures[];
+
+//  ITexture::bindlessIndex() of the texture of the draw
+layout(push_constant) uniform TextureSlot {
+    uint index;
+} slot;
+
+void main() {
+    outColor = vec4(fragColor * texture(textures[slot.index], fragTexture).rgb, 1.0);
+}